@@ -0,0 +1,38 @@
+#ifndef IA_PRACTICE_BATCH_H_
+#define IA_PRACTICE_BATCH_H_
+
+#include <cstddef>
+#include <string>
+
+#include "search.h"
+
+// Opciones comunes a todas las consultas de un lote.
+struct BatchOptions {
+  unsigned threads = 0;   // hilos para construir cada grafo (0 = todos)
+  std::size_t depth = 2;  // capacidad de cada cola entre etapas
+  SearchLimits limits;    // se aplican a cada consulta
+  std::size_t convert_bytes = DiskGraph::kDefaultChunkBytes;  // bloque al convertir (bfs-ext)
+};
+
+/**
+ * @brief Ejecuta un fichero de consultas solapando carga, búsqueda y volcado.
+ *
+ * Una consulta por línea: "grafo origen destino [estrategia] [salida]" (líneas vacías y
+ * las que empiezan por '#' se ignoran). Si falta la salida se usa "resultado_<k>.txt";
+ * si termina en ".trace" se guarda la traza binaria en lugar del informe de texto.
+ *
+ * Tres etapas en hilos distintos, unidas por colas de capacidad 'depth':
+ * - carga: lee el lote y parsea el grafo de la siguiente consulta (reutiliza el último
+ *   si se repite el fichero);
+ * - búsqueda: ejecuta la estrategia (hilo llamante);
+ * - volcado: escribe informes o trazas.
+ * Las colas llenas frenan a la etapa anterior: la carga no se adelanta más de 'depth'
+ * consultas y la búsqueda no acumula más de 'depth' resultados sin escribir, así que la
+ * memoria está acotada aunque el lote sea largo.
+ * Si se activa opts.limits.cancel se interrumpe la carga en curso, la búsqueda en curso
+ * deja su informe parcial y las consultas pendientes se descartan sin informe.
+ * @return true si todas las consultas se completaron y se escribieron.
+ */
+bool RunBatch(const std::string& batch_path, const BatchOptions& opts);
+
+#endif  // IA_PRACTICE_BATCH_H_
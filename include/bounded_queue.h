@@ -0,0 +1,68 @@
+#ifndef IA_PRACTICE_BOUNDED_QUEUE_H_
+#define IA_PRACTICE_BOUNDED_QUEUE_H_
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+/**
+ * @brief Cola FIFO bloqueante de capacidad fija para encadenar etapas en hilos distintos.
+ *
+ * Push espera mientras la cola está llena (contrapresión: la etapa rápida no se adelanta
+ * más de 'capacity' elementos) y Pop espera mientras está vacía. Tras Close, Push
+ * descarta y Pop devuelve std::nullopt en cuanto se vacía.
+ */
+template <typename T>
+class BoundedQueue {
+ public:
+  explicit BoundedQueue(std::size_t capacity) : capacity_(std::max<std::size_t>(1, capacity)) {}
+
+  /**
+   * @brief Encola 'item'. Devuelve false si la cola está cerrada.
+   */
+  bool Push(T item) {
+    std::unique_lock<std::mutex> lock(mu_);
+    not_full_.wait(lock, [this] { return closed_ || items_.size() < capacity_; });
+    if (closed_) return false;
+    items_.push_back(std::move(item));
+    not_empty_.notify_one();
+    return true;
+  }
+
+  /**
+   * @brief Desencola el siguiente elemento, o std::nullopt si está cerrada y vacía.
+   */
+  std::optional<T> Pop() {
+    std::unique_lock<std::mutex> lock(mu_);
+    not_empty_.wait(lock, [this] { return closed_ || !items_.empty(); });
+    if (items_.empty()) return std::nullopt;
+    T item = std::move(items_.front());
+    items_.pop_front();
+    not_full_.notify_one();
+    return item;
+  }
+
+  /**
+   * @brief No se aceptan más elementos; los ya encolados se pueden seguir sacando.
+   */
+  void Close() {
+    std::lock_guard<std::mutex> lock(mu_);
+    closed_ = true;
+    not_full_.notify_all();
+    not_empty_.notify_all();
+  }
+
+ private:
+  std::mutex mu_;
+  std::condition_variable not_full_;
+  std::condition_variable not_empty_;
+  std::deque<T> items_;
+  const std::size_t capacity_;
+  bool closed_ = false;
+};
+
+#endif  // IA_PRACTICE_BOUNDED_QUEUE_H_
@@ -0,0 +1,19 @@
+#ifndef IA_PRACTICE_CANCELLATION_H_
+#define IA_PRACTICE_CANCELLATION_H_
+
+#include <atomic>
+
+// Token de cancelación cooperativa: otro hilo (o un manejador de señal) lo activa y la
+// búsqueda (o la carga del grafo) lo consulta periódicamente.
+class CancellationToken {
+ public:
+  void Cancel() { cancelled_.store(true, std::memory_order_relaxed); }
+  void Reset() { cancelled_.store(false, std::memory_order_relaxed); }
+  bool IsCancelled() const { return cancelled_.load(std::memory_order_relaxed); }
+
+ private:
+  static_assert(std::atomic<bool>::is_always_lock_free, "se activa desde manejadores de señal");
+  std::atomic<bool> cancelled_{false};
+};
+
+#endif  // IA_PRACTICE_CANCELLATION_H_
@@ -0,0 +1,107 @@
+#ifndef IA_PRACTICE_DISK_GRAPH_H_
+#define IA_PRACTICE_DISK_GRAPH_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+
+#include "cancellation.h"
+
+/**
+ * @brief Grafo no dirigido guardado en disco (CSR binario) y proyectado con mmap.
+ *
+ * Pensado para grafos que no caben en memoria: las filas de adyacencia se leen bajo
+ * demanda a través de la proyección, de modo que el sistema solo carga las páginas
+ * que se tocan. Los vecinos de cada vértice están en orden ascendente.
+ *
+ * Formato del fichero (little-endian nativo):
+ * - Cabecera: magic "IAGRAPH1" (8 bytes), n (uint64), m (uint64)
+ * - offsets: n+1 uint64; los vecinos de v (1..n) están en [offsets[v-1], offsets[v])
+ * - neighbors: 2m int32 (ids 1..n)
+ * - costs: 2m double, paralelo a neighbors
+ */
+class DiskGraph {
+ public:
+  DiskGraph() = default;
+  ~DiskGraph();
+
+  DiskGraph(const DiskGraph&) = delete;
+  DiskGraph& operator=(const DiskGraph&) = delete;
+
+  // Memoria por defecto para el bloque de filas de ConvertFromText.
+  static constexpr std::size_t kDefaultChunkBytes = std::size_t{64} << 20;
+
+  /**
+   * @brief Convierte un fichero con el formato del guion al formato binario en disco.
+   *
+   * Dos pasadas lineales sobre el texto: la primera cuenta los grados y la segunda rellena
+   * las filas por bloques de como mucho 'chunk_bytes', que se escriben de forma secuencial.
+   * Las entradas destinadas a bloques posteriores se derivan a ficheros de derrame en
+   * TempDir() (en total, como mucho 16 bytes por arista). En memoria: un offset por
+   * vértice, el bloque actual y del orden de 'chunk_bytes' de derrames pendientes.
+   * El resultado se escribe en un temporal único '<bin_path>.tmp.XXXXXX' y se renombra
+   * al final.
+   * Si 'cancel' se activa (se consulta por fila), se abandona y se borran los temporales.
+   * @return true si la conversión termina correctamente.
+   */
+  static bool ConvertFromText(const std::string& text_path, const std::string& bin_path,
+                              const CancellationToken* cancel = nullptr,
+                              std::size_t chunk_bytes = kDefaultChunkBytes);
+
+  /**
+   * @brief Abre y proyecta (solo lectura) un fichero binario generado por ConvertFromText.
+   *
+   * Valida la cabecera, el tamaño y los offsets; los ids de los vecinos no se recorren
+   * aquí (sería leer el fichero entero) y los comprueba quien los usa.
+   */
+  bool Open(const std::string& path);
+
+  /**
+   * @brief Abre 'path' si ya es un binario (.adj); si no, abre '<path>.adj', que se
+   *        (re)genera antes solo si no existe o es más antiguo que el texto.
+   * @param cancel, chunk_bytes Se pasan a ConvertFromText.
+   */
+  bool OpenOrConvert(const std::string& path, const CancellationToken* cancel = nullptr,
+                     std::size_t chunk_bytes = kDefaultChunkBytes);
+
+  /**
+   * @brief Ruta del binario abierto.
+   */
+  const std::string& path() const { return path_; }
+
+  /**
+   * @brief Número de vértices (1..n).
+   */
+  std::size_t NumVertices() const { return n_; }
+
+  /**
+   * @brief Número de aristas (no dirigidas) presentes.
+   */
+  std::size_t NumEdges() const { return m_; }
+
+  /**
+   * @brief Vecinos de v (1-based), leídos de la proyección. En un fichero válido son
+   *        ids 1..n ascendentes; un fichero corrupto puede contener ids fuera de rango.
+   */
+  std::span<const int> Neighbors(int v) const;
+
+  /**
+   * @brief Coste de la arista (u,v). Devuelve -1.0 si no existe.
+   */
+  double EdgeCost(int u, int v) const;
+
+ private:
+  void Close();
+
+  std::string path_;
+  std::size_t n_ = 0;
+  std::size_t m_ = 0;
+  void* map_ = nullptr;                        // proyección completa del fichero
+  std::size_t map_size_ = 0;
+  const std::uint64_t* offsets_ = nullptr;     // [n+1]
+  const int* neighbors_ = nullptr;             // [2m]
+  const double* costs_ = nullptr;              // [2m]
+};
+
+#endif  // IA_PRACTICE_DISK_GRAPH_H_
@@ -2,18 +2,24 @@
 #define IA_PRACTICE_GRAPH_H_
 
 #include <cstddef>
+#include <span>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "cancellation.h"
+
 /**
- * @brief Representa un grafo no dirigido con matriz de costes y lista de adyacencia.
+ * @brief Representa un grafo no dirigido con costes triangulares y lista de adyacencia CSR.
  *
  * El formato del fichero de entrada sigue exactamente el del guion:
  * - Primera línea: n (número de vértices)
  * - A continuación n(n-1)/2 distancias d(i,j) en orden lexicográfico por pares (i<j):
  *   (1,2), (1,3), ..., (1,n), (2,3), ..., (n-1,n)
  * - d(i,i) = 0 (implícito), d(i,j) = d(j,i), y d(i,j) = -1 si no hay arista.
+ *
+ * Los costes se guardan tal cual se leen (triángulo superior, sin matriz densa) y la
+ * lista de adyacencia se construye en paralelo en formato CSR (offsets + vecinos).
  */
 class Graph {
  public:
@@ -22,9 +28,13 @@ class Graph {
   /**
    * @brief Carga el grafo desde un fichero de texto con el formato del guion.
    * @param path Ruta del fichero.
+   * @param num_threads Hilos para construir la lista de adyacencia (0 = todos los disponibles;
+   *        nunca más que núcleos).
+   * @param cancel Si se activa durante la lectura, la carga se abandona (opcional).
    * @return true si se carga con éxito, false en caso contrario.
    */
-  bool LoadFromFile(const std::string& path);
+  bool LoadFromFile(const std::string& path, unsigned num_threads = 0,
+                    const CancellationToken* cancel = nullptr);
 
   /**
    * @brief Número de vértices (1..n).
@@ -32,9 +42,9 @@ class Graph {
   std::size_t NumVertices() const { return n_; }
 
   /**
-   * @brief Devuelve los vecinos (ids 1..n) accesibles desde v (1-based).
+   * @brief Devuelve los vecinos (ids 1..n, ascendentes) accesibles desde v (1-based).
    */
-  const std::vector<int>& Neighbors(int v) const;
+  std::span<const int> Neighbors(int v) const;
 
   /**
    * @brief Coste de la arista (u,v). Devuelve -1.0 si no existe.
@@ -47,12 +57,18 @@ class Graph {
   std::size_t NumEdges() const { return m_; }
 
  private:
-  void BuildAdjacencyList();
+  void BuildAdjacencyList(unsigned num_threads);
+
+  // Posición de d(i,j) (0-based, i<j) dentro de weights_.
+  std::size_t TriIndex(std::size_t i, std::size_t j) const {
+    return i * n_ - i * (i + 1) / 2 + (j - i - 1);
+  }
 
   std::size_t n_ = 0;  // número de vértices
   std::size_t m_ = 0;  // número de aristas no dirigidas
-  std::vector<std::vector<double>> adj_matrix_;  // [n][n], -1 si no hay arista
-  std::vector<std::vector<int>> adj_list_;       // vecinos por índice 1..n
+  std::vector<double> weights_;         // n(n-1)/2 costes en el orden del fichero, -1 si no hay arista
+  std::vector<std::size_t> offsets_;    // [n+2], vecinos de v en [offsets_[v], offsets_[v+1])
+  std::vector<int> neighbors_;          // 2m ids de vecinos concatenados (CSR)
 };
 
 #endif  // IA_PRACTICE_GRAPH_H_
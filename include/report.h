@@ -0,0 +1,41 @@
+#ifndef IA_PRACTICE_REPORT_H_
+#define IA_PRACTICE_REPORT_H_
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+
+#include "search.h"
+
+// Datos de cabecera del informe que no forman parte de SearchResult.
+struct ReportHeader {
+  std::string strategy;          // "BFS", "DFS", ...
+  std::size_t num_vertices = 0;
+  std::size_t num_edges = 0;
+  int origin = -1;
+  int dest = -1;
+};
+
+/**
+ * @brief Escribe el informe legible ("Iteracion" a "Iteracion", camino y coste).
+ * @return false si la traza está corrupta (el informe se corta ahí) o falla la escritura.
+ */
+bool WriteReport(std::ostream& out, const ReportHeader& header, const SearchResult& r);
+
+/**
+ * @brief Guarda cabecera y resultado en el formato binario de traza.
+ *
+ * Formato: magic "IATRACE1" seguido de varints: estrategia (longitud + bytes), n, m,
+ * origen/destino, found y motivo de parada (1 byte cada uno), coste (double, 8 bytes),
+ * camino, número de iteraciones y el búfer de Trace (longitud + bytes).
+ * @return true si se escribe correctamente.
+ */
+bool WriteTraceFile(const std::string& path, const ReportHeader& header, const SearchResult& r);
+
+/**
+ * @brief Lee un fichero generado por WriteTraceFile.
+ * @return true si el fichero es válido.
+ */
+bool ReadTraceFile(const std::string& path, ReportHeader* header, SearchResult* r);
+
+#endif  // IA_PRACTICE_REPORT_H_
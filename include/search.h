@@ -1,40 +1,76 @@
 #ifndef IA_PRACTICE_SEARCH_H_
 #define IA_PRACTICE_SEARCH_H_
 
+#include <chrono>
+#include <cstddef>
 #include <string>
 #include <vector>
 
+#include "cancellation.h"
+#include "disk_graph.h"
 #include "graph.h"
+#include "trace.h"
 
 // Estrategia de búsqueda.
-enum class Strategy { kBfs, kDfs, kBfsMulti };
+enum class Strategy { kBfs, kDfs, kBfsMulti, kBfsExternal };
+
+// "bfs", "dfs", "bfs-multi", "bfs-ext" (también en mayúsculas); por defecto BFS.
+Strategy StrategyFromString(const std::string& s);
+const char* StrategyName(Strategy st);
+
+// Motivo por el que terminó una búsqueda.
+enum class StopReason {
+  kCompleted,       // terminó sola (camino encontrado o espacio agotado)
+  kTimeLimit,       // superó SearchLimits::time_budget
+  kExpansionLimit,  // alcanzó SearchLimits::max_expansions
+  kMemoryLimit,     // sus estructuras superaron SearchLimits::max_memory_bytes
+  kCancelled,       // se activó el CancellationToken
+  kError,           // fallo de E/S o datos corruptos (ver el mensaje por std::cerr)
+};
+
+const char* StopReasonName(StopReason reason);
+
+// Límites por consulta (0 / nullptr = sin límite).
+struct SearchLimits {
+  std::chrono::milliseconds time_budget{0};  // tiempo de reloj
+  std::size_t max_expansions = 0;            // iteraciones (nodos expandidos)
+  std::size_t max_memory_bytes = 0;          // estimación de frontera + acumulados + trazas
+  const CancellationToken* cancel = nullptr;
+};
 
 // Resultado completo con trazas por iteración.
 struct SearchResult {
   std::vector<int> path;                    // Camino final (1..n).
   double total_cost = -1.0;                 // Coste total del camino, -1 si no existe.
 
-  // Una iteración = una expansión de un nodo.
-  std::vector<int> expanded_nodes;                  // Nodo expandido en cada iteración.
-  std::vector<std::vector<int>> successors_step;    // Sucesores vistos esa iteración.
-  std::vector<std::vector<int>> enqueued_step;      // Sucesores realmente encolados/apilados.
-
-  // Acumulados (con duplicados) que se imprimen en el informe.
-  std::vector<std::vector<int>> generated_acc;      // Historial de “nodos generados” (con duplicados).
-  std::vector<std::vector<int>> inspected_acc;      // Historial de “nodos inspeccionados”.
+  // Una iteración = una expansión de un nodo: nodo expandido, sucesores vistos y
+  // encolados/apilados, y los acumulados (generados con duplicados, inspeccionados)
+  // que se imprimen en el informe. Codificado de forma compacta (ver trace.h).
+  Trace trace;
 
   bool found = false;                                // true si se halló un camino.
+  StopReason stop_reason = StopReason::kCompleted;   // si no es kCompleted, resultado parcial.
 };
 
 class UninformedSearch {
  public:
-  static SearchResult Run(const Graph& g, int origin, int dest, Strategy strategy);
+  // kBfsExternal no se admite aquí (devuelve kError): usar RunExternal.
+  static SearchResult Run(const Graph& g, int origin, int dest, Strategy strategy,
+                          const SearchLimits& limits = {});
   static double ComputePathCost(const Graph& g, const std::vector<int>& path);
+  static double ComputePathCost(const DiskGraph& g, const std::vector<int>& path);
+
+  // BFS por niveles sobre un grafo en disco: en memoria solo hay mapas de bits (visitados,
+  // frontera actual y siguiente); los padres se vuelcan a un temporal propio en TempDir()
+  // y el camino se reconstruye al final. No guarda trazas por iteración.
+  static SearchResult RunExternal(const DiskGraph& g, int origin, int dest,
+                                  const SearchLimits& limits = {});
 
  private:
-  static SearchResult Bfs(const Graph& g, int origin, int dest);
-  static SearchResult Dfs(const Graph& g, int origin, int dest);
-  static SearchResult BfsMulti(const Graph& g, int origin, int dest, int max_runs);
+  static SearchResult Bfs(const Graph& g, int origin, int dest, const SearchLimits& limits);
+  static SearchResult Dfs(const Graph& g, int origin, int dest, const SearchLimits& limits);
+  static SearchResult BfsMulti(const Graph& g, int origin, int dest, int max_runs,
+                               const SearchLimits& limits);
 };
 
 #endif  // IA_PRACTICE_SEARCH_H_
@@ -0,0 +1,18 @@
+#ifndef IA_PRACTICE_TEMP_FILE_H_
+#define IA_PRACTICE_TEMP_FILE_H_
+
+#include <string>
+
+/**
+ * @brief Directorio para ficheros temporales: $TMPDIR si está definido, si no /tmp.
+ */
+std::string TempDir();
+
+/**
+ * @brief Crea un fichero vacío (permisos 0600) con nombre único: 'prefix' seguido de seis
+ *        caracteres elegidos por mkstemp, de modo que dos procesos nunca compartan temporal.
+ * @return Ruta del fichero creado, o cadena vacía si no se pudo crear.
+ */
+std::string CreateUniqueFile(const std::string& prefix);
+
+#endif  // IA_PRACTICE_TEMP_FILE_H_
@@ -0,0 +1,116 @@
+#ifndef IA_PRACTICE_TRACE_H_
+#define IA_PRACTICE_TRACE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Trazas por iteración de una búsqueda, codificadas en un único búfer contiguo.
+ *
+ * Cada iteración (una expansión) guarda el nodo expandido, las listas acumuladas de
+ * generados e inspeccionados y, si se llegó a expandir, sus sucesores y encolados.
+ * - Las listas acumuladas solo guardan el sufijo nuevo: cuántos elementos se conservan
+ *   de la iteración anterior y los que se añaden. Las búsquedas solo añaden al final (o
+ *   reinician con ResetLists), así que basta recordar la longitud anterior: cada
+ *   iteración cuesta O(sufijo nuevo).
+ * - Los ids se escriben como diferencias con el anterior (zigzag) en varint.
+ */
+class Trace {
+ public:
+  // Iteración decodificada.
+  struct Step {
+    int expanded = -1;
+    std::vector<int> generated;   // acumulado (con duplicados) al inicio de la iteración
+    std::vector<int> inspected;   // acumulado al inicio de la iteración
+    std::vector<int> successors;  // vacíos si la iteración no expandió sucesores
+    std::vector<int> enqueued;
+  };
+
+  // Recorre las iteraciones en orden (las acumuladas dependen de la anterior).
+  class Reader {
+   public:
+    // Resultado de Next: iteración leída, fin de la traza o búfer corrupto.
+    enum class Status { kStep, kEnd, kError };
+
+    explicit Reader(const Trace& trace) : trace_(trace) {}
+
+    /**
+     * @brief Decodifica la siguiente iteración en *step.
+     *
+     * Solo la última iteración puede quedar abierta (sin sucesores ni encolados): sus
+     * listas acumuladas terminan entonces justo al final del búfer. Una iteración anterior
+     * sin esas listas, o bytes sobrantes tras la última, se consideran corrupción.
+     */
+    Status Next(Step* step);
+
+   private:
+    const Trace& trace_;
+    std::size_t pos_ = 0;
+    std::size_t step_ = 0;
+    std::vector<int> generated_;  // acumuladas de la iteración anterior
+    std::vector<int> inspected_;
+  };
+
+  /**
+   * @brief Abre una iteración con las listas acumuladas tal y como están al empezar.
+   *
+   * Entre dos iteraciones cada lista solo puede crecer por el final; para empezar de cero
+   * (p. ej. un nuevo intento) hay que llamar antes a ResetLists. Solo se comprueban la
+   * longitud y el elemento frontera, no el contenido ya escrito.
+   */
+  void BeginStep(int expanded, const std::vector<int>& generated,
+                 const std::vector<int>& inspected);
+
+  /**
+   * @brief Las listas acumuladas de la siguiente iteración se escriben enteras.
+   */
+  void ResetLists() {
+    prev_generated_ = {};
+    prev_inspected_ = {};
+  }
+
+  /**
+   * @brief Cierra la iteración abierta con los sucesores vistos y los encolados.
+   */
+  void EndStep(const std::vector<int>& successors, const std::vector<int>& enqueued);
+
+  std::size_t NumSteps() const { return steps_; }
+
+  /**
+   * @brief Memoria reservada por la traza (búfer codificado).
+   */
+  std::size_t MemoryBytes() const { return buf_.capacity(); }
+  bool Empty() const { return steps_ == 0; }
+
+  /**
+   * @brief Búfer codificado (para volcarlo a disco) y reconstrucción a partir de él.
+   */
+  const std::vector<std::uint8_t>& bytes() const { return buf_; }
+  static Trace FromBytes(std::vector<std::uint8_t> bytes, std::size_t num_steps);
+
+ private:
+  void CloseOpenStep();
+
+  std::vector<std::uint8_t> buf_;
+  std::size_t steps_ = 0;
+  // Extremo de una lista acumulada en la iteración anterior.
+  struct ListEnd {
+    std::size_t size = 0;
+    int last = 0;
+  };
+
+  bool open_ = false;        // última iteración aún sin sucesores
+  ListEnd prev_generated_;   // para codificar solo el sufijo nuevo
+  ListEnd prev_inspected_;
+};
+
+/**
+ * @brief Primitivas varint/zigzag compartidas con el formato binario de traza.
+ */
+void PutVarint(std::vector<std::uint8_t>* buf, std::uint64_t v);
+bool GetVarint(const std::vector<std::uint8_t>& buf, std::size_t* pos, std::uint64_t* v);
+void PutIdList(std::vector<std::uint8_t>* buf, const int* ids, std::size_t count);
+bool GetIdList(const std::vector<std::uint8_t>& buf, std::size_t* pos, std::vector<int>* ids);
+
+#endif  // IA_PRACTICE_TRACE_H_
@@ -0,0 +1,190 @@
+#include "batch.h"
+
+#include <atomic>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <thread>
+#include <utility>
+
+#include "bounded_queue.h"
+#include "disk_graph.h"
+#include "graph.h"
+#include "report.h"
+
+namespace {
+
+struct Query {
+  std::size_t index = 0;  // 1..k, para la salida por defecto
+  std::string graph_path;
+  int origin = -1;
+  int dest = -1;
+  Strategy strategy = Strategy::kBfs;
+  std::string output_path;
+};
+
+// Consulta con su grafo ya cargado (carga -> búsqueda).
+struct LoadedQuery {
+  Query query;
+  std::shared_ptr<const Graph> graph;           // estrategias en memoria
+  std::shared_ptr<const DiskGraph> disk_graph;  // bfs-ext
+};
+
+// Resultado pendiente de escribir (búsqueda -> volcado).
+struct PendingReport {
+  ReportHeader header;
+  SearchResult result;
+  std::string output_path;
+};
+
+bool ParseQuery(const std::string& line, std::size_t index, Query* q) {
+  std::istringstream in(line);
+  if (!(in >> q->graph_path >> q->origin >> q->dest)) return false;
+  std::string strategy;
+  if (!(in >> strategy)) strategy = "bfs";
+  if (!(in >> q->output_path)) q->output_path = "resultado_" + std::to_string(index) + ".txt";
+  q->strategy = StrategyFromString(strategy);
+  q->index = index;
+  return true;
+}
+
+bool Cancelled(const BatchOptions& opts) {
+  return opts.limits.cancel != nullptr && opts.limits.cancel->IsCancelled();
+}
+
+// Etapa de carga: lee el lote línea a línea y prepara el grafo de cada consulta.
+void LoadStage(std::istream& batch, const BatchOptions& opts, BoundedQueue<LoadedQuery>* out,
+               std::atomic<bool>* failed) {
+  std::shared_ptr<const Graph> graph;  // último grafo cargado, para consultas seguidas
+  std::string graph_path;
+  std::shared_ptr<const DiskGraph> disk_graph;
+  std::string disk_path;
+
+  std::string line;
+  std::size_t index = 0;
+  while (!Cancelled(opts) && std::getline(batch, line)) {
+    const std::size_t first = line.find_first_not_of(" \t\r");
+    if (first == std::string::npos || line[first] == '#') continue;
+
+    LoadedQuery lq;
+    if (!ParseQuery(line, ++index, &lq.query)) {
+      std::cerr << "Error: consulta invalida en el lote: " << line << "\n";
+      *failed = true;
+      continue;
+    }
+    const std::string& path = lq.query.graph_path;
+
+    if (lq.query.strategy == Strategy::kBfsExternal) {
+      // Volver a un grafo anterior (A, B, A) no pisa el .adj que pueda estar proyectado
+      // todavía: OpenOrConvert lo reutiliza si está al día y, si no, convierte a un
+      // temporal y lo renombra, de modo que la proyección vieja sigue siendo válida.
+      if (!disk_graph || disk_path != path) {
+        auto dg = std::make_shared<DiskGraph>();
+        disk_graph.reset();
+        if (!dg->OpenOrConvert(path, opts.limits.cancel, opts.convert_bytes)) {
+          *failed = true;
+          continue;
+        }
+        disk_graph = std::move(dg);
+        disk_path = path;
+      }
+      lq.disk_graph = disk_graph;
+    } else {
+      if (!graph || graph_path != path) {
+        graph.reset();  // lo libera en cuanto la búsqueda termine con él
+        auto g = std::make_shared<Graph>();
+        if (!g->LoadFromFile(path, opts.threads, opts.limits.cancel)) {
+          *failed = true;
+          continue;
+        }
+        graph = std::move(g);
+        graph_path = path;
+      }
+      lq.graph = graph;
+    }
+
+    if (!out->Push(std::move(lq))) break;
+  }
+  out->Close();
+}
+
+// Etapa de búsqueda: ejecuta cada consulta y suelta su grafo antes de pasar el resultado.
+// Tras una cancelación sigue vaciando la cola (para no bloquear la carga) pero descarta
+// sin informe las consultas que aún no habían empezado.
+void SearchStage(const BatchOptions& opts, BoundedQueue<LoadedQuery>* in,
+                 BoundedQueue<PendingReport>* out, std::atomic<bool>* failed) {
+  while (auto lq = in->Pop()) {
+    if (Cancelled(opts)) {
+      *failed = true;
+      continue;
+    }
+    const Query& q = lq->query;
+    PendingReport rep;
+    rep.output_path = q.output_path;
+    if (lq->disk_graph) {
+      const DiskGraph& dg = *lq->disk_graph;
+      rep.result = UninformedSearch::RunExternal(dg, q.origin, q.dest, opts.limits);
+      rep.header = {StrategyName(q.strategy), dg.NumVertices(), dg.NumEdges(), q.origin, q.dest};
+    } else {
+      const Graph& g = *lq->graph;
+      rep.result = UninformedSearch::Run(g, q.origin, q.dest, q.strategy, opts.limits);
+      if (rep.result.found) {
+        rep.result.total_cost = UninformedSearch::ComputePathCost(g, rep.result.path);
+      }
+      rep.header = {StrategyName(q.strategy), g.NumVertices(), g.NumEdges(), q.origin, q.dest};
+    }
+    lq.reset();
+    if (!out->Push(std::move(rep))) break;
+  }
+  out->Close();
+}
+
+// Etapa de volcado: informe de texto o traza binaria según la extensión de la salida.
+void WriteStage(BoundedQueue<PendingReport>* in, std::atomic<bool>* failed) {
+  while (auto rep = in->Pop()) {
+    if (rep->result.stop_reason != StopReason::kCompleted) *failed = true;
+
+    if (rep->output_path.ends_with(".trace")) {
+      if (WriteTraceFile(rep->output_path, rep->header, rep->result)) {
+        std::cout << "Traza generada en: " << rep->output_path << "\n";
+      } else {
+        *failed = true;
+      }
+      continue;
+    }
+    std::ofstream out(rep->output_path);
+    if (!out) {
+      std::cerr << "Error: no se pudo abrir el fichero de salida: " << rep->output_path << "\n";
+      *failed = true;
+      continue;
+    }
+    if (!WriteReport(out, rep->header, rep->result)) {
+      std::cerr << "Error: informe incompleto en: " << rep->output_path << "\n";
+      *failed = true;
+      continue;
+    }
+    std::cout << "Informe generado en: " << rep->output_path << "\n";
+  }
+}
+
+}  // namespace
+
+bool RunBatch(const std::string& batch_path, const BatchOptions& opts) {
+  std::ifstream batch(batch_path);
+  if (!batch) {
+    std::cerr << "Error: no se pudo abrir el fichero de lote: " << batch_path << "\n";
+    return false;
+  }
+
+  BoundedQueue<LoadedQuery> loaded(opts.depth);
+  BoundedQueue<PendingReport> reports(opts.depth);
+  std::atomic<bool> failed{false};
+
+  std::thread loader([&] { LoadStage(batch, opts, &loaded, &failed); });
+  std::thread writer([&] { WriteStage(&reports, &failed); });
+  SearchStage(opts, &loaded, &reports, &failed);
+  loader.join();
+  writer.join();
+  return !failed;
+}
@@ -0,0 +1,361 @@
+#include "disk_graph.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+#include "temp_file.h"
+
+static_assert(sizeof(int) == 4, "el formato en disco usa ids de 32 bits");
+
+namespace {
+
+constexpr char kMagic[8] = {'I', 'A', 'G', 'R', 'A', 'P', 'H', '1'};
+constexpr std::size_t kHeaderSize = sizeof(kMagic) + 2 * sizeof(std::uint64_t);
+
+// Tamaño total del fichero para n vértices y m aristas.
+std::size_t FileSize(std::size_t n, std::size_t m) {
+  return kHeaderSize + (n + 1) * sizeof(std::uint64_t) + 2 * m * sizeof(int) +
+         2 * m * sizeof(double);
+}
+
+// Vecino de una fila de un bloque posterior, guardado hasta que se rellena ese bloque.
+struct SpillEntry {
+  int row;       // 0-based
+  int neighbor;  // 1..n
+  double cost;
+};
+
+// Lee la cabecera del fichero de texto; deja el flujo apuntando a la primera distancia.
+bool ReadTextHeader(std::ifstream& in, const std::string& path, std::size_t* n) {
+  if (!in) {
+    std::cerr << "Error: no se pudo abrir el fichero: " << path << "\n";
+    return false;
+  }
+  if (!(in >> *n) || *n == 0) {
+    std::cerr << "Error: n invalido o ausente en el fichero.\n";
+    return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+DiskGraph::~DiskGraph() { Close(); }
+
+void DiskGraph::Close() {
+  if (map_ != nullptr) munmap(map_, map_size_);
+  map_ = nullptr;
+  map_size_ = 0;
+  path_.clear();
+  n_ = 0;
+  m_ = 0;
+  offsets_ = nullptr;
+  neighbors_ = nullptr;
+  costs_ = nullptr;
+}
+
+bool DiskGraph::ConvertFromText(const std::string& text_path, const std::string& bin_path,
+                                const CancellationToken* cancel, std::size_t chunk_bytes) {
+  auto cancelled = [&]() {
+    if (cancel == nullptr || !cancel->IsCancelled()) return false;
+    std::cerr << "Conversion cancelada: " << text_path << "\n";
+    return true;
+  };
+
+  // -------- Pasada 1: grados por vértice --------
+  std::ifstream in(text_path);
+  std::size_t n = 0;
+  if (!ReadTextHeader(in, text_path, &n)) return false;
+
+  const std::size_t expected = (n * (n - 1)) / 2;
+  std::vector<std::uint64_t> offsets(n + 1, 0);  // offsets[x+1] = grado de x (0-based)
+  std::size_t m = 0;
+  double w = -1.0;
+  for (std::size_t i = 0; i + 1 < n; ++i) {
+    if (cancelled()) return false;
+    for (std::size_t j = i + 1; j < n; ++j) {
+      if (!(in >> w)) {
+        std::cerr << "Error: faltan distancias; esperados " << expected << " valores.\n";
+        return false;
+      }
+      if (w >= 0.0) {
+        ++offsets[i + 1];
+        ++offsets[j + 1];
+        ++m;
+      }
+    }
+  }
+  for (std::size_t v = 1; v <= n; ++v) offsets[v] += offsets[v - 1];
+
+  // Se escribe en un temporal y se renombra al final: quien tenga proyectado el .adj
+  // anterior sigue leyendo el fichero viejo, nunca uno a medio escribir. El nombre es
+  // único (dos conversiones simultáneas no se mezclan) y está junto al .adj para que
+  // rename sea atómico.
+  const std::string tmp_path = CreateUniqueFile(bin_path + ".tmp.");
+  if (tmp_path.empty()) {
+    std::cerr << "Error: no se pudo crear un temporal junto a: " << bin_path << "\n";
+    return false;
+  }
+  ::chmod(tmp_path.c_str(), 0644);  // mkstemp lo crea 0600; el .adj se comparte como antes
+  std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+  if (!out) {
+    std::cerr << "Error: no se pudo crear el fichero: " << tmp_path << "\n";
+    std::remove(tmp_path.c_str());
+    return false;
+  }
+  std::vector<std::string> spill_paths;  // derrames por bloque de la pasada de relleno
+  auto discard = [&]() {
+    out.close();
+    std::remove(tmp_path.c_str());
+    for (const std::string& p : spill_paths) {
+      if (!p.empty()) std::remove(p.c_str());
+    }
+    return false;
+  };
+  auto fail = [&](const char* what) {
+    std::cerr << "Error: " << what << ": " << bin_path << "\n";
+    return discard();
+  };
+
+  const std::uint64_t n64 = n;
+  const std::uint64_t m64 = m;
+  out.write(kMagic, sizeof(kMagic));
+  out.write(reinterpret_cast<const char*>(&n64), sizeof(n64));
+  out.write(reinterpret_cast<const char*>(&m64), sizeof(m64));
+  out.write(reinterpret_cast<const char*>(offsets.data()),
+            static_cast<std::streamsize>(offsets.size() * sizeof(std::uint64_t)));
+  const std::size_t neighbors_base = kHeaderSize + (n + 1) * sizeof(std::uint64_t);
+  const std::size_t costs_base = neighbors_base + 2 * m * sizeof(int);
+
+  // -------- Pasada de relleno, por bloques de filas [lo, hi) --------
+  // Cada bloque se rellena en memoria (como mucho 'chunk_bytes', o una fila si es mayor) y
+  // se escribe de una vez: las escrituras al fichero son secuenciales. El texto se lee una
+  // sola vez más: la fila i aporta a sí misma los vecinos j>i y a cada fila j el vecino i.
+  // Si j es de un bloque posterior, la entrada se deriva al fichero de derrame de ese
+  // bloque, que se vacía al empezar a rellenarlo.
+  // La fila v recibe así primero los vecinos i<v (derrame y filas anteriores del bloque,
+  // en orden de i) y después los j>v (su propia fila), y un cursor por vértice la deja
+  // ordenada.
+  constexpr std::size_t kEntryBytes = sizeof(int) + sizeof(double);
+  std::vector<std::size_t> block_lo;  // primera fila de cada bloque, y n al final
+  for (std::size_t lo = 0; lo < n;) {
+    block_lo.push_back(lo);
+    std::size_t hi = lo + 1;
+    while (hi < n && (offsets[hi + 1] - offsets[lo]) * kEntryBytes <= chunk_bytes) ++hi;
+    lo = hi;
+  }
+  block_lo.push_back(n);
+  const std::size_t num_blocks = block_lo.size() - 1;
+
+  // Entradas derivadas aún en memoria; entre todos los bloques ocupan del orden de
+  // 'chunk_bytes' y cada uno se añade a su fichero al llenarse.
+  spill_paths.assign(num_blocks, {});
+  std::vector<std::vector<SpillEntry>> pending(num_blocks);
+  const std::size_t pending_cap =
+      std::max<std::size_t>(256, chunk_bytes / sizeof(SpillEntry) / num_blocks);
+  auto flush = [&](std::size_t b) {
+    if (spill_paths[b].empty()) {
+      spill_paths[b] = CreateUniqueFile(TempDir() + "/ia-convert-");
+      if (spill_paths[b].empty()) return false;
+    }
+    std::ofstream spill(spill_paths[b], std::ios::binary | std::ios::app);
+    spill.write(reinterpret_cast<const char*>(pending[b].data()),
+                static_cast<std::streamsize>(pending[b].size() * sizeof(SpillEntry)));
+    spill.close();
+    pending[b].clear();
+    return !spill.fail();
+  };
+
+  std::ifstream rows(text_path);
+  std::size_t rows_n = 0;
+  if (!ReadTextHeader(rows, text_path, &rows_n) || rows_n != n) {
+    return fail("el texto cambio durante la conversion");
+  }
+  std::vector<int> neighbors;
+  std::vector<double> costs;
+  std::vector<std::uint64_t> cursor;
+  std::vector<SpillEntry> chunk;  // lectura por trozos de un derrame
+  for (std::size_t b = 0; b < num_blocks; ++b) {
+    const std::size_t lo = block_lo[b];
+    const std::size_t hi = block_lo[b + 1];
+    const std::uint64_t first = offsets[lo];
+    neighbors.assign(offsets[hi] - first, 0);
+    costs.assign(offsets[hi] - first, 0.0);
+    cursor.assign(offsets.begin() + static_cast<std::ptrdiff_t>(lo),
+                  offsets.begin() + static_cast<std::ptrdiff_t>(hi));
+    // false si la fila ya está llena (el texto no coincide con la primera pasada)
+    auto place = [&](std::size_t row, int neighbor, double cost) {
+      if (cursor[row - lo] >= offsets[row + 1]) return false;
+      const std::uint64_t k = cursor[row - lo]++ - first;
+      neighbors[k] = neighbor;
+      costs[k] = cost;
+      return true;
+    };
+
+    // Vecinos que aportaron las filas de bloques anteriores: primero lo ya volcado
+    if (!spill_paths[b].empty()) {
+      std::ifstream spill(spill_paths[b], std::ios::binary);
+      chunk.resize(pending_cap);
+      do {
+        spill.read(reinterpret_cast<char*>(chunk.data()),
+                   static_cast<std::streamsize>(chunk.size() * sizeof(SpillEntry)));
+        const auto got = static_cast<std::size_t>(spill.gcount());
+        if (got % sizeof(SpillEntry) != 0) return fail("derrame de conversion incompleto");
+        for (std::size_t k = 0; k < got / sizeof(SpillEntry); ++k) {
+          if (!place(static_cast<std::size_t>(chunk[k].row), chunk[k].neighbor, chunk[k].cost)) {
+            return fail("el texto cambio durante la conversion");
+          }
+        }
+      } while (spill);
+      if (spill.bad()) return fail("no se pudo leer el derrame de conversion");
+      spill.close();
+      std::remove(spill_paths[b].c_str());
+      spill_paths[b].clear();
+    }
+    for (const SpillEntry& e : pending[b]) {
+      if (!place(static_cast<std::size_t>(e.row), e.neighbor, e.cost)) {
+        return fail("el texto cambio durante la conversion");
+      }
+    }
+    std::vector<SpillEntry>().swap(pending[b]);
+
+    for (std::size_t i = lo; i < hi && i + 1 < n; ++i) {
+      if (cancelled()) return discard();
+      std::size_t bj = b;  // bloque de j; j crece a lo largo de la fila
+      for (std::size_t j = i + 1; j < n; ++j) {
+        if (!(rows >> w)) return fail("el texto cambio durante la conversion");
+        if (w < 0.0) continue;
+        while (j >= block_lo[bj + 1]) ++bj;
+        const bool ok = place(i, static_cast<int>(j) + 1, w) &&
+                        (bj != b || place(j, static_cast<int>(i) + 1, w));
+        if (!ok) return fail("el texto cambio durante la conversion");
+        if (bj == b) continue;
+        pending[bj].push_back({static_cast<int>(j), static_cast<int>(i) + 1, w});
+        if (pending[bj].size() >= pending_cap && !flush(bj)) {
+          return fail("no se pudo escribir el derrame de conversion");
+        }
+      }
+    }
+
+    out.seekp(static_cast<std::streamoff>(neighbors_base + first * sizeof(int)));
+    out.write(reinterpret_cast<const char*>(neighbors.data()),
+              static_cast<std::streamsize>(neighbors.size() * sizeof(int)));
+    out.seekp(static_cast<std::streamoff>(costs_base + first * sizeof(double)));
+    out.write(reinterpret_cast<const char*>(costs.data()),
+              static_cast<std::streamsize>(costs.size() * sizeof(double)));
+    if (!out) return fail("no se pudo escribir el fichero");
+  }
+
+  out.close();
+  if (!out) return fail("no se pudo volcar el fichero");
+  if (std::rename(tmp_path.c_str(), bin_path.c_str()) != 0) {
+    return fail("no se pudo renombrar el temporal");
+  }
+  return true;
+}
+
+bool DiskGraph::Open(const std::string& path) {
+  Close();
+
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    std::cerr << "Error: no se pudo abrir el fichero: " << path << "\n";
+    return false;
+  }
+  struct stat st {};
+  if (::fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < kHeaderSize) {
+    std::cerr << "Error: fichero binario de grafo invalido: " << path << "\n";
+    ::close(fd);
+    return false;
+  }
+  const std::size_t size = static_cast<std::size_t>(st.st_size);
+  void* map = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (map == MAP_FAILED) {
+    std::cerr << "Error: no se pudo proyectar el fichero: " << path << "\n";
+    return false;
+  }
+
+  const auto* base = static_cast<const unsigned char*>(map);
+  std::uint64_t n64 = 0;
+  std::uint64_t m64 = 0;
+  std::memcpy(&n64, base + sizeof(kMagic), sizeof(n64));
+  std::memcpy(&m64, base + sizeof(kMagic) + sizeof(n64), sizeof(m64));
+  auto invalid = [&]() {
+    std::cerr << "Error: fichero binario de grafo invalido: " << path << "\n";
+    munmap(map, size);
+    return false;
+  };
+  // Cotas antes de FileSize para que no desborde con una cabecera manipulada
+  const std::size_t body = size - kHeaderSize;
+  if (std::memcmp(base, kMagic, sizeof(kMagic)) != 0 || n64 == 0 ||
+      n64 > static_cast<std::uint64_t>(std::numeric_limits<int>::max()) ||
+      n64 >= body / sizeof(std::uint64_t) ||
+      m64 > body / (2 * (sizeof(int) + sizeof(double))) || FileSize(n64, m64) != size) {
+    return invalid();
+  }
+  // Offsets: empiezan en 0, no decrecen y terminan en 2m (así Neighbors no se sale)
+  const auto* offsets = reinterpret_cast<const std::uint64_t*>(base + kHeaderSize);
+  if (offsets[0] != 0 || offsets[n64] != 2 * m64 ||
+      std::adjacent_find(offsets, offsets + n64 + 1, std::greater<>()) != offsets + n64 + 1) {
+    return invalid();
+  }
+
+  // Las filas se recorren en orden creciente de vértice: lectura secuencial
+  madvise(map, size, MADV_SEQUENTIAL);
+
+  map_ = map;
+  map_size_ = size;
+  path_ = path;
+  n_ = n64;
+  m_ = m64;
+  offsets_ = offsets;
+  neighbors_ = reinterpret_cast<const int*>(offsets_ + n_ + 1);
+  costs_ = reinterpret_cast<const double*>(neighbors_ + 2 * m_);
+  return true;
+}
+
+bool DiskGraph::OpenOrConvert(const std::string& path, const CancellationToken* cancel,
+                              std::size_t chunk_bytes) {
+  if (path.ends_with(".adj")) return Open(path);
+  const std::string bin_path = path + ".adj";
+
+  // Un .adj posterior al texto ya está al día: se reutiliza sin volver a convertir
+  std::error_code text_err, bin_err;
+  const auto text_time = std::filesystem::last_write_time(path, text_err);
+  const auto bin_time = std::filesystem::last_write_time(bin_path, bin_err);
+  if (!text_err && !bin_err && bin_time >= text_time && Open(bin_path)) return true;
+
+  return ConvertFromText(path, bin_path, cancel, chunk_bytes) && Open(bin_path);
+}
+
+std::span<const int> DiskGraph::Neighbors(int v) const {
+  // v es 1..n
+  const std::size_t k = static_cast<std::size_t>(v);
+  return {neighbors_ + offsets_[k - 1], offsets_[k] - offsets_[k - 1]};
+}
+
+double DiskGraph::EdgeCost(int u, int v) const {
+  if (u < 1 || v < 1 || u > static_cast<int>(n_) || v > static_cast<int>(n_)) {
+    return -1.0;
+  }
+  if (u == v) return 0.0;
+  // Fila ordenada: búsqueda binaria de v entre los vecinos de u
+  const auto row = Neighbors(u);
+  const auto it = std::lower_bound(row.begin(), row.end(), v);
+  if (it == row.end() || *it != v) return -1.0;
+  const std::size_t k = static_cast<std::size_t>(u);
+  return costs_[offsets_[k - 1] + static_cast<std::size_t>(it - row.begin())];
+}
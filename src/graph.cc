@@ -1,15 +1,35 @@
 #include "graph.h"
 
+#include <algorithm>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <stdexcept>
+#include <thread>
 
-bool Graph::LoadFromFile(const std::string& path) {
+namespace {
+
+// Ejecuta fn(t) para t = 0..num_threads-1, cada uno en su hilo, y espera a todos.
+template <typename Fn>
+void ParallelFor(unsigned num_threads, const Fn& fn) {
+  std::vector<std::thread> pool;
+  pool.reserve(num_threads > 0 ? num_threads - 1 : 0);
+  for (unsigned t = 1; t < num_threads; ++t) {
+    pool.emplace_back(fn, t);
+  }
+  fn(0u);
+  for (auto& th : pool) th.join();
+}
+
+}  // namespace
+
+bool Graph::LoadFromFile(const std::string& path, unsigned num_threads,
+                         const CancellationToken* cancel) {
   n_ = 0;
   m_ = 0;
-  adj_matrix_.clear();
-  adj_list_.clear();
+  weights_.clear();
+  offsets_.clear();
+  neighbors_.clear();
 
   std::ifstream in(path);
   if (!in) {
@@ -23,50 +43,114 @@ bool Graph::LoadFromFile(const std::string& path) {
     return false;
   }
 
-  // Inicializa matriz con -1, y 0 en diagonal
-  adj_matrix_.assign(n_, std::vector<double>(n_, -1.0));
-  for (std::size_t i = 0; i < n_; ++i) {
-    adj_matrix_[i][i] = 0.0;
-  }
-
-  // Se esperan n(n-1)/2 valores en el orden (1,2), (1,3), ... (n-1,n)
+  // Se esperan n(n-1)/2 valores en el orden (1,2), (1,3), ... (n-1,n); se guardan tal cual
   const std::size_t expected = (n_ * (n_ - 1)) / 2;
+  weights_.reserve(expected);
   double w = -1.0;
-  std::size_t idx = 0;
-  for (std::size_t i = 0; i < n_ - 1; ++i) {
-    for (std::size_t j = i + 1; j < n_; ++j) {
-      if (!(in >> w)) {
-        std::cerr << "Error: faltan distancias; esperados " << expected
-                  << " valores.\n";
-        return false;
-      }
-      adj_matrix_[i][j] = w;
-      adj_matrix_[j][i] = w;
-      if (w >= 0.0) {
-        ++m_;
-      }
-      ++idx;
+  for (std::size_t idx = 0; idx < expected; ++idx) {
+    // El token se consulta cada 4096 valores para no frenar la lectura
+    if (cancel != nullptr && idx % 4096 == 0 && cancel->IsCancelled()) {
+      std::cerr << "Carga cancelada: " << path << "\n";
+      n_ = 0;
+      m_ = 0;
+      weights_.clear();
+      return false;
+    }
+    if (!(in >> w)) {
+      std::cerr << "Error: faltan distancias; esperados " << expected
+                << " valores.\n";
+      return false;
+    }
+    weights_.push_back(w);
+    if (w >= 0.0) {
+      ++m_;
     }
   }
 
-  BuildAdjacencyList();
+  BuildAdjacencyList(num_threads);
   return true;
 }
 
-void Graph::BuildAdjacencyList() {
-  adj_list_.assign(n_ + 1, {});  // índices 1..n cómodos
-  for (std::size_t i = 0; i < n_; ++i) {
-    for (std::size_t j = 0; j < n_; ++j) {
-      if (i != j && adj_matrix_[i][j] >= 0.0) {
-        adj_list_[static_cast<int>(i) + 1].push_back(static_cast<int>(j) + 1);
+// Construcción CSR en dos pasadas sobre el triángulo superior:
+//  1) cada hilo cuenta, para sus filas i, las aristas (i,j>i) de la fila y las que aporta
+//     a la columna j (contadores privados por hilo, sin atómicos);
+//  2) suma prefija -> offsets_ y cursores de escritura por (hilo, vértice);
+//  3) cada hilo rellena sus huecos en neighbors_ directamente.
+// Los vecinos de cada vértice quedan en orden ascendente, igual que con la matriz densa.
+void Graph::BuildAdjacencyList(unsigned num_threads) {
+  // Más hilos que núcleos no acelera y 'lower' crece con threads * n
+  const unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+  unsigned threads = num_threads == 0 ? hw : std::min(num_threads, hw);
+  threads = static_cast<unsigned>(std::min<std::size_t>(threads, n_));
+
+  // Reparto de filas equilibrado por número de celdas (la fila i tiene n-1-i)
+  std::vector<std::size_t> first_row(threads + 1, n_);
+  first_row[0] = 0;
+  {
+    const std::size_t total = weights_.size();
+    std::size_t acc = 0;
+    unsigned t = 1;
+    for (std::size_t i = 0; i < n_ && t < threads; ++i) {
+      while (t < threads && acc >= total * t / threads) first_row[t++] = i;
+      acc += n_ - 1 - i;
+    }
+  }
+
+  std::vector<std::size_t> upper(n_, 0);            // aristas (i,j>i), cada fila de un solo hilo
+  std::vector<std::size_t> lower(threads * n_, 0);  // [t][j]: aristas (i<j,j) que aporta el hilo t
+
+  ParallelFor(threads, [&](unsigned t) {
+    std::size_t* low = lower.data() + t * n_;
+    for (std::size_t i = first_row[t]; i < first_row[t + 1]; ++i) {
+      const double* row = weights_.data() + TriIndex(i, i + 1);
+      std::size_t count = 0;
+      for (std::size_t j = i + 1; j < n_; ++j) {
+        if (row[j - i - 1] >= 0.0) {
+          ++count;
+          ++low[j];
+        }
       }
+      upper[i] = count;
     }
+  });
+
+  // Suma prefija. Dentro de cada vértice: primero los vecinos menores (por hilo, en orden)
+  // y después los mayores, de modo que el resultado queda ordenado.
+  offsets_.assign(n_ + 2, 0);  // índices 1..n cómodos
+  std::size_t running = 0;
+  for (std::size_t v = 0; v < n_; ++v) {
+    offsets_[v + 1] = running;
+    for (unsigned t = 0; t < threads; ++t) {
+      const std::size_t c = lower[t * n_ + v];
+      lower[t * n_ + v] = running;
+      running += c;
+    }
+    const std::size_t c = upper[v];
+    upper[v] = running;
+    running += c;
   }
+  offsets_[n_ + 1] = running;
+  neighbors_.assign(running, 0);
+
+  ParallelFor(threads, [&](unsigned t) {
+    std::size_t* cursor = lower.data() + t * n_;
+    for (std::size_t i = first_row[t]; i < first_row[t + 1]; ++i) {
+      const double* row = weights_.data() + TriIndex(i, i + 1);
+      std::size_t up = upper[i];
+      for (std::size_t j = i + 1; j < n_; ++j) {
+        if (row[j - i - 1] >= 0.0) {
+          neighbors_[up++] = static_cast<int>(j) + 1;
+          neighbors_[cursor[j]++] = static_cast<int>(i) + 1;
+        }
+      }
+    }
+  });
 }
 
-const std::vector<int>& Graph::Neighbors(int v) const {
+std::span<const int> Graph::Neighbors(int v) const {
   // v es 1..n
-  return adj_list_[v];
+  const std::size_t k = static_cast<std::size_t>(v);
+  return {neighbors_.data() + offsets_[k], offsets_[k + 1] - offsets_[k]};
 }
 
 double Graph::EdgeCost(int u, int v) const {
@@ -76,5 +160,7 @@ double Graph::EdgeCost(int u, int v) const {
   if (i < 0 || j < 0 || i >= static_cast<int>(n_) || j >= static_cast<int>(n_)) {
     return -1.0;
   }
-  return adj_matrix_[i][j];
+  if (i == j) return 0.0;
+  if (i > j) std::swap(i, j);
+  return weights_[TriIndex(static_cast<std::size_t>(i), static_cast<std::size_t>(j))];
 }
@@ -1,4 +1,7 @@
 #include <algorithm>
+#include <charconv>
+#include <csignal>
+#include <cstdint>
 #include <cstdlib>
 #include <fstream>
 #include <iomanip>
@@ -7,7 +10,10 @@
 #include <string>
 #include <vector>
 
+#include "batch.h"
+#include "disk_graph.h"
 #include "graph.h"
+#include "report.h"
 #include "search.h"
 
 namespace {
@@ -18,6 +24,30 @@ struct CliOptions {
   std::optional<int> dest;
   std::string strategy = "bfs";  // "bfs" o "dfs"
   std::string output_path = "resultado.txt";
+  unsigned threads = 0;          // hilos para construir el grafo (0 = todos)
+  std::string trace_path;        // si no está vacío, traza binaria en vez de informe
+  SearchLimits limits;           // --time-limit-ms, --max-expansions, --max-memory-mb
+  std::string batch_path;        // --batch: lote de consultas en modo segmentado
+  std::size_t pipeline_depth = 2;
+  std::size_t convert_bytes = DiskGraph::kDefaultChunkBytes;  // --convert-mem-mb (bfs-ext)
+};
+
+// Ctrl+C durante una búsqueda por parámetros la detiene y se vuelca el resultado parcial.
+CancellationToken g_cancel;
+
+void OnSigint(int) { g_cancel.Cancel(); }
+
+// Solo mientras vive, Ctrl+C cancela en vez de terminar el programa: fuera de la
+// búsqueda (p. ej. cargando el grafo) interrumpe sin dejar ningún informe.
+class SigintScope {
+ public:
+  SigintScope() {
+    g_cancel.Reset();
+    std::signal(SIGINT, OnSigint);
+  }
+  ~SigintScope() { std::signal(SIGINT, SIG_DFL); }
+  SigintScope(const SigintScope&) = delete;
+  SigintScope& operator=(const SigintScope&) = delete;
 };
 
 void PrintMenu() {
@@ -29,6 +59,14 @@ void PrintMenu() {
   std::cout << "5) Salir\n";
 }
 
+// Entero sin signo completo (sin signo, espacios ni sufijos); false si no cabe en T.
+template <typename T>
+bool ParseNumber(const char* s, T* out) {
+  const char* end = s + std::char_traits<char>::length(s);
+  const auto [ptr, ec] = std::from_chars(s, end, *out);
+  return ec == std::errc() && ptr == end && ptr != s;
+}
+
 bool ParseArgs(int argc, char* argv[], CliOptions* opts) {
   for (int i = 1; i < argc; ++i) {
     std::string a = argv[i];
@@ -42,6 +80,30 @@ bool ParseArgs(int argc, char* argv[], CliOptions* opts) {
       opts->strategy = argv[++i];
     } else if (a == "--output" && i + 1 < argc) {
       opts->output_path = argv[++i];
+    } else if (a == "--trace" && i + 1 < argc) {
+      opts->trace_path = argv[++i];
+    } else if (a == "--time-limit-ms" && i + 1 < argc) {
+      opts->limits.time_budget = std::chrono::milliseconds(std::stoll(argv[++i]));
+    } else if (a == "--max-expansions" && i + 1 < argc) {
+      opts->limits.max_expansions = std::stoull(argv[++i]);
+    } else if (a == "--max-memory-mb" && i + 1 < argc) {
+      opts->limits.max_memory_bytes = std::stoull(argv[++i]) * 1024 * 1024;
+    } else if (a == "--batch" && i + 1 < argc) {
+      opts->batch_path = argv[++i];
+    } else if (a == "--pipeline-depth" && i + 1 < argc) {
+      opts->pipeline_depth = std::stoull(argv[++i]);
+    } else if (a == "--convert-mem-mb" && i + 1 < argc) {
+      std::size_t mb = 0;
+      if (!ParseNumber(argv[++i], &mb) || mb == 0 || mb > (SIZE_MAX >> 20)) {
+        std::cerr << "Valor invalido para --convert-mem-mb: " << argv[i] << "\n";
+        return false;
+      }
+      opts->convert_bytes = mb << 20;
+    } else if (a == "--threads" && i + 1 < argc) {
+      if (!ParseNumber(argv[++i], &opts->threads)) {
+        std::cerr << "Valor invalido para --threads: " << argv[i] << "\n";
+        return false;
+      }
     } else {
       std::cerr << "Argumento desconocido o incompleto: " << a << "\n";
       return false;
@@ -55,122 +117,95 @@ bool ParseArgs(int argc, char* argv[], CliOptions* opts) {
 //  return Strategy::kBfs;
 //}
 
-Strategy StrategyFromString(const std::string& s) {
-  if (s == "dfs" || s == "DFS") return Strategy::kDfs;
-  if (s == "bfs-multi" || s == "BFS-MULTI" || s == "bfsmulti" || s == "BFSMULTI")
-    return Strategy::kBfsMulti;
-  return Strategy::kBfs;
-}
 
+// Cabecera del informe para la ejecución actual.
+ReportHeader MakeHeader(std::size_t num_vertices, std::size_t num_edges, int origin, int dest,
+                        Strategy st) {
+  return {StrategyName(st), num_vertices, num_edges, origin, dest};
+}
 
-// Informe bonito (estilo propio: corchetes y separadores).
-void DumpReport(const Graph& g, int origin, int dest, const SearchResult& r,
-                const std::string& out_path, Strategy st) {
+bool DumpReport(const ReportHeader& header, const SearchResult& r, const std::string& out_path) {
   std::ofstream out(out_path);
   if (!out) {
     std::cerr << "Error: no se pudo abrir el fichero de salida: " << out_path << "\n";
-    return;
+    return false;
   }
-
-  out << "============================================\n";
-  out << "         EJECUCION " << (st == Strategy::kBfs ? "BFS" : "DFS") << "\n";
-  out << "============================================\n\n";
-
-  out << "Vertices del grafo : " << g.NumVertices() << "\n";
-  out << "Aristas del grafo  : " << g.NumEdges() << "\n";
-  out << "Origen             : " << origin << "\n";
-  out << "Destino            : " << dest << "\n";
-  out << "--------------------------------------------\n\n";
-
-  const std::size_t steps = r.expanded_nodes.size();
-  for (std::size_t i = 0; i < steps; ++i) {
-    out << "----------- Iteracion " << (i + 1) << " -----------\n";
-
-    // Generados acumulados (con duplicados)
-    out << "Nodos generados: [ ";
-    if (i < r.generated_acc.size() && !r.generated_acc[i].empty()) {
-      for (std::size_t j = 0; j < r.generated_acc[i].size(); ++j) {
-        if (j) out << ", ";
-        out << r.generated_acc[i][j];
-      }
-    } else {
-      out << "-";
-    }
-    out << " ]\n";
-
-    // Inspeccionados acumulados
-    out << "Nodos inspeccionados: [ ";
-    if (i < r.inspected_acc.size() && !r.inspected_acc[i].empty()) {
-      for (std::size_t j = 0; j < r.inspected_acc[i].size(); ++j) {
-        if (j) out << ", ";
-        out << r.inspected_acc[i][j];
-      }
-    } else {
-      out << "-";
-    }
-    out << " ]\n";
-
-    // Nodo expandido y sucesores
-    out << ">> Nodo expandido: " << r.expanded_nodes[i] << "\n";
-    out << "   Sucesores: [ ";
-    if (i < r.successors_step.size()) {
-      for (std::size_t j = 0; j < r.successors_step[i].size(); ++j) {
-        if (j) out << ", ";
-        out << r.successors_step[i][j];
-      }
-    }
-    out << " ]\n";
-
-    // Comentarios por sucesor (si no se encola o si es destino)
-    auto was_enqueued = [&](int v) -> bool {
-      if (i >= r.enqueued_step.size()) return false;
-      return std::find(r.enqueued_step[i].begin(), r.enqueued_step[i].end(), v) !=
-             r.enqueued_step[i].end();
-    };
-    if (i < r.successors_step.size()) {
-      for (int v : r.successors_step[i]) {
-        if (v == dest) {
-          out << "   -> El nodo " << v << " es el OBJETIVO alcanzado!\n";
-        } else if (!was_enqueued(v)) {
-          out << "   -> El nodo " << v << " no se añade (ya visitado o es padre).\n";
-        }
-      }
-    }
-
-    out << "============================================\n\n";
+  if (!WriteReport(out, header, r)) {
+    std::cerr << "Error: no se pudo escribir el informe: " << out_path << "\n";
+    return false;
   }
+  std::cout << "Informe generado en: " << out_path << "\n";
+  return true;
+}
 
-  if (r.found) {
-    out << "============= CAMINO ENCONTRADO =============\n";
-    for (std::size_t i = 0; i < r.path.size(); ++i) {
-      if (i) out << " -> ";
-      out << r.path[i];
-    }
-    out << "\nCoste total: " << std::fixed << std::setprecision(2) << r.total_cost << "\n";
-  } else {
-    out << "============= CAMINO NO ENCONTRADO =============\n";
-  }
+// Con --trace se guarda la traza binaria (compacta) en lugar del informe de texto;
+// el informe se obtiene después con bin/trace_report.
+// Devuelve false si no se pudo escribir.
+bool DumpResult(const CliOptions& opts, const ReportHeader& header, const SearchResult& r) {
+  if (opts.trace_path.empty()) return DumpReport(header, r, opts.output_path);
+  if (!WriteTraceFile(opts.trace_path, header, r)) return false;
+  std::cout << "Traza generada en: " << opts.trace_path << "\n";
+  return true;
+}
 
-  out << "============================================\n";
-  std::cout << "Informe generado en: " << out_path << "\n";
+// Código de salida del modo por parámetros: un resultado parcial (límite, Ctrl+C o
+// error) también es un fallo, igual que en el modo por lotes.
+int ExitStatus(bool written, const SearchResult& r) {
+  return written && r.stop_reason == StopReason::kCompleted ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+// BFS externo: el grafo nunca se carga entero (ver DiskGraph::OpenOrConvert).
+// Devuelve false si no se pudo abrir o convertir el grafo.
+bool RunExternalSearch(const std::string& input_path, int origin, int dest,
+                       const SearchLimits& limits, std::size_t convert_bytes,
+                       ReportHeader* header, SearchResult* res) {
+  DiskGraph dg;
+  if (!dg.OpenOrConvert(input_path, nullptr, convert_bytes)) return false;
+  SigintScope sigint;
+  *res = UninformedSearch::RunExternal(dg, origin, dest, limits);
+  *header = MakeHeader(dg.NumVertices(), dg.NumEdges(), origin, dest, Strategy::kBfsExternal);
+  return true;
 }
 
 }  // namespace
 
 int main(int argc, char* argv[]) {
   CliOptions opts;
-  ParseArgs(argc, argv, &opts);
+  if (!ParseArgs(argc, argv, &opts)) return EXIT_FAILURE;
 
   Graph g;
 
   // Modo por parámetros
-  if (!opts.input_path.empty() && g.LoadFromFile(opts.input_path)) {
+  opts.limits.cancel = &g_cancel;
+  if (!opts.batch_path.empty()) {
+    SigintScope sigint;
+    return RunBatch(opts.batch_path,
+                    {opts.threads, opts.pipeline_depth, opts.limits, opts.convert_bytes})
+               ? EXIT_SUCCESS
+               : EXIT_FAILURE;
+  }
+  if (!opts.input_path.empty() && opts.origin.has_value() && opts.dest.has_value() &&
+      StrategyFromString(opts.strategy) == Strategy::kBfsExternal) {
+    ReportHeader header;
+    SearchResult res;
+    if (!RunExternalSearch(opts.input_path, *opts.origin, *opts.dest, opts.limits,
+                           opts.convert_bytes, &header, &res)) {
+      return EXIT_FAILURE;
+    }
+    return ExitStatus(DumpResult(opts, header, res), res);
+  }
+  if (!opts.input_path.empty() && g.LoadFromFile(opts.input_path, opts.threads)) {
     if (opts.origin.has_value() && opts.dest.has_value()) {
       Strategy st = StrategyFromString(opts.strategy);
-      SearchResult res = UninformedSearch::Run(g, *opts.origin, *opts.dest, st);
+      SearchResult res;
+      {
+        SigintScope sigint;
+        res = UninformedSearch::Run(g, *opts.origin, *opts.dest, st, opts.limits);
+      }
       if (res.found) res.total_cost = UninformedSearch::ComputePathCost(g, res.path);
-      DumpReport(g, *opts.origin, *opts.dest, res, opts.output_path, st);
-      return EXIT_SUCCESS;
+      const ReportHeader header =
+          MakeHeader(g.NumVertices(), g.NumEdges(), *opts.origin, *opts.dest, st);
+      return ExitStatus(DumpResult(opts, header, res), res);
     }
   }
 
@@ -179,6 +214,8 @@ int main(int argc, char* argv[]) {
   int origin = -1, dest = -1;
   std::string strat = "dfs";        // por defecto DFS (puedes cambiarlo)
   std::string out_path = "resultado.txt";
+  SearchLimits limits;  // Ctrl+C durante la búsqueda la detiene y vuelve al menú
+  limits.cancel = &g_cancel;
 
   while (true) {
     PrintMenu();
@@ -198,22 +235,37 @@ int main(int argc, char* argv[]) {
       std::cout << "Origen: "; std::cin >> origin;
       std::cout << "Destino: "; std::cin >> dest;
     } else if (op == 3) {
-      std::cout << "Estrategia [dfs | bfs | bfs-multi]: ";
+      std::cout << "Estrategia [dfs | bfs | bfs-multi | bfs-ext]: ";
       std::cin >> strat;
       Strategy st = StrategyFromString(strat);
       std::cout << "Estrategia seleccionada: "
-              << (st == Strategy::kDfs ? "DFS" : (st == Strategy::kBfs ? "BFS" : "BFS-MULTI"))
-              << "\n";
+              << StrategyName(st) << "\n";
     } else if (op == 4) {
       if (path.empty() || origin < 1 || dest < 1) {
         std::cout << "Faltan datos (grafo/origen/destino).\n";
         continue;
       }
       Strategy st = StrategyFromString(strat);
-      std::cout << "Ejecutando " << (st == Strategy::kDfs ? "DFS" : (st == Strategy::kBfs ? "BFS" : "BFS-MULTI")) << "...\n";
-      SearchResult r = UninformedSearch::Run(g, origin, dest, st);
+      std::cout << "Ejecutando " << StrategyName(st) << "...\n";
+      if (st == Strategy::kBfsExternal) {
+        // Se recorre la copia en disco del fichero, no el grafo cargado en memoria
+        ReportHeader header;
+        SearchResult r;
+        if (!RunExternalSearch(path, origin, dest, limits, DiskGraph::kDefaultChunkBytes,
+                               &header, &r)) {
+          std::cout << "Error abriendo el grafo en disco.\n";
+          continue;
+        }
+        DumpReport(header, r, out_path);
+        continue;
+      }
+      SearchResult r;
+      {
+        SigintScope sigint;
+        r = UninformedSearch::Run(g, origin, dest, st, limits);
+      }
       if (r.found) r.total_cost = UninformedSearch::ComputePathCost(g, r.path);
-      DumpReport(g, origin, dest, r, out_path, st);
+      DumpReport(MakeHeader(g.NumVertices(), g.NumEdges(), origin, dest, st), r, out_path);
       std::cout << "Informe generado en: " << out_path << "\n";
     } else if (op == 5) {
       break;
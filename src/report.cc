@@ -0,0 +1,175 @@
+#include "report.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <vector>
+
+namespace {
+
+constexpr char kTraceMagic[8] = {'I', 'A', 'T', 'R', 'A', 'C', 'E', '1'};
+
+// Imprime "[ a, b, c ]"; si la lista está vacía y hay 'empty', "[ - ]".
+void PrintList(std::ostream& out, const std::vector<int>& ids, const char* empty) {
+  out << "[ ";
+  if (ids.empty()) {
+    out << empty;
+  }
+  for (std::size_t j = 0; j < ids.size(); ++j) {
+    if (j) out << ", ";
+    out << ids[j];
+  }
+  out << " ]\n";
+}
+
+}  // namespace
+
+// Informe bonito (estilo propio: corchetes y separadores).
+bool WriteReport(std::ostream& out, const ReportHeader& header, const SearchResult& r) {
+  out << "============================================\n";
+  out << "         EJECUCION " << header.strategy << "\n";
+  out << "============================================\n\n";
+
+  out << "Vertices del grafo : " << header.num_vertices << "\n";
+  out << "Aristas del grafo  : " << header.num_edges << "\n";
+  out << "Origen             : " << header.origin << "\n";
+  out << "Destino            : " << header.dest << "\n";
+  out << "--------------------------------------------\n\n";
+
+  Trace::Reader reader(r.trace);
+  Trace::Step step;
+  Trace::Reader::Status status;
+  std::size_t i = 0;
+  for (; (status = reader.Next(&step)) == Trace::Reader::Status::kStep; ++i) {
+    out << "----------- Iteracion " << (i + 1) << " -----------\n";
+
+    // Generados acumulados (con duplicados) e inspeccionados acumulados
+    out << "Nodos generados: ";
+    PrintList(out, step.generated, "-");
+    out << "Nodos inspeccionados: ";
+    PrintList(out, step.inspected, "-");
+
+    // Nodo expandido y sucesores
+    out << ">> Nodo expandido: " << step.expanded << "\n";
+    out << "   Sucesores: ";
+    PrintList(out, step.successors, "");
+
+    // Comentarios por sucesor (si no se encola o si es destino)
+    for (int v : step.successors) {
+      if (v == header.dest) {
+        out << "   -> El nodo " << v << " es el OBJETIVO alcanzado!\n";
+      } else if (std::find(step.enqueued.begin(), step.enqueued.end(), v) ==
+                 step.enqueued.end()) {
+        out << "   -> El nodo " << v << " no se añade (ya visitado o es padre).\n";
+      }
+    }
+
+    out << "============================================\n\n";
+  }
+  if (status == Trace::Reader::Status::kError) {
+    std::cerr << "Error: traza corrupta tras la iteracion " << i << "\n";
+    out << "============= TRAZA CORRUPTA =============\n";
+    return false;
+  }
+
+  if (r.found) {
+    out << "============= CAMINO ENCONTRADO =============\n";
+    for (std::size_t i = 0; i < r.path.size(); ++i) {
+      if (i) out << " -> ";
+      out << r.path[i];
+    }
+    out << "\nCoste total: " << std::fixed << std::setprecision(2) << r.total_cost << "\n";
+  } else if (r.stop_reason != StopReason::kCompleted) {
+    out << "============= BUSQUEDA DETENIDA =============\n";
+    out << "Motivo: " << StopReasonName(r.stop_reason) << " (resultado parcial)\n";
+  } else {
+    out << "============= CAMINO NO ENCONTRADO =============\n";
+  }
+
+  out << "============================================\n";
+  return static_cast<bool>(out);
+}
+
+bool WriteTraceFile(const std::string& path, const ReportHeader& header, const SearchResult& r) {
+  std::vector<std::uint8_t> buf(std::begin(kTraceMagic), std::end(kTraceMagic));
+  PutVarint(&buf, header.strategy.size());
+  buf.insert(buf.end(), header.strategy.begin(), header.strategy.end());
+  PutVarint(&buf, header.num_vertices);
+  PutVarint(&buf, header.num_edges);
+  const int ends[2] = {header.origin, header.dest};  // como lista: admite valores negativos
+  PutIdList(&buf, ends, 2);
+  buf.push_back(r.found ? 1 : 0);
+  buf.push_back(static_cast<std::uint8_t>(r.stop_reason));
+  std::uint8_t cost[sizeof(double)];
+  std::memcpy(cost, &r.total_cost, sizeof(cost));
+  buf.insert(buf.end(), std::begin(cost), std::end(cost));
+  PutIdList(&buf, r.path.data(), r.path.size());
+  PutVarint(&buf, r.trace.NumSteps());
+  PutVarint(&buf, r.trace.bytes().size());
+
+  std::ofstream out(path, std::ios::binary);
+  if (!out) {
+    std::cerr << "Error: no se pudo abrir el fichero de traza: " << path << "\n";
+    return false;
+  }
+  out.write(reinterpret_cast<const char*>(buf.data()), static_cast<std::streamsize>(buf.size()));
+  out.write(reinterpret_cast<const char*>(r.trace.bytes().data()),
+            static_cast<std::streamsize>(r.trace.bytes().size()));
+  return static_cast<bool>(out);
+}
+
+bool ReadTraceFile(const std::string& path, ReportHeader* header, SearchResult* r) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in) {
+    std::cerr << "Error: no se pudo abrir el fichero de traza: " << path << "\n";
+    return false;
+  }
+  const std::vector<std::uint8_t> buf((std::istreambuf_iterator<char>(in)),
+                                      std::istreambuf_iterator<char>());
+
+  auto fail = [&path]() {
+    std::cerr << "Error: fichero de traza invalido: " << path << "\n";
+    return false;
+  };
+  if (buf.size() < sizeof(kTraceMagic) ||
+      std::memcmp(buf.data(), kTraceMagic, sizeof(kTraceMagic)) != 0) {
+    return fail();
+  }
+  std::size_t pos = sizeof(kTraceMagic);
+
+  std::uint64_t len = 0;
+  if (!GetVarint(buf, &pos, &len) || len > buf.size() - pos) return fail();
+  header->strategy.assign(buf.begin() + static_cast<std::ptrdiff_t>(pos),
+                          buf.begin() + static_cast<std::ptrdiff_t>(pos + len));
+  pos += len;
+
+  std::uint64_t n = 0, m = 0;
+  std::vector<int> ends;
+  if (!GetVarint(buf, &pos, &n) || !GetVarint(buf, &pos, &m) ||
+      !GetIdList(buf, &pos, &ends) || ends.size() != 2 ||
+      buf.size() - pos < 2 + sizeof(double) ||
+      buf[pos + 1] > static_cast<std::uint8_t>(StopReason::kError)) {
+    return fail();
+  }
+  header->num_vertices = n;
+  header->num_edges = m;
+  header->origin = ends[0];
+  header->dest = ends[1];
+  r->found = buf[pos++] != 0;
+  r->stop_reason = static_cast<StopReason>(buf[pos++]);
+  std::memcpy(&r->total_cost, buf.data() + pos, sizeof(double));
+  pos += sizeof(double);
+
+  std::uint64_t steps = 0;
+  if (!GetIdList(buf, &pos, &r->path) || !GetVarint(buf, &pos, &steps) ||
+      !GetVarint(buf, &pos, &len) || len != buf.size() - pos) {
+    return fail();
+  }
+  r->trace = Trace::FromBytes(
+      std::vector<std::uint8_t>(buf.begin() + static_cast<std::ptrdiff_t>(pos), buf.end()),
+      steps);
+  return true;
+}
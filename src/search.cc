@@ -1,12 +1,20 @@
 #include "search.h"
 
 #include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
 #include <deque>
+#include <fstream>
+#include <iostream>
 #include <stack>
 #include <unordered_map>
 #include <unordered_set>
 #include <random> 
 
+#include "temp_file.h"
+
 
 namespace {
 
@@ -24,6 +32,88 @@ std::vector<int> ReconstructPath(int origin, int goal, const std::vector<int>& p
   return path;
 }
 
+// Suma de costes a lo largo del camino; -1 si falta alguna arista.
+template <typename G>
+double PathCost(const G& g, const std::vector<int>& path) {
+  if (path.size() < 2) return 0.0;
+  double cost = 0.0;
+  for (std::size_t i = 1; i < path.size(); ++i) {
+    double w = g.EdgeCost(path[i - 1], path[i]);
+    if (w < 0.0) return -1.0;
+    cost += w;
+  }
+  return cost;
+}
+
+// Mapa de bits sobre los ids 0..size-1 (se usan 1..n).
+class Bitmap {
+ public:
+  explicit Bitmap(std::size_t size) : words_((size + 63) / 64, 0) {}
+
+  bool Test(std::size_t i) const { return (words_[i >> 6] >> (i & 63)) & 1u; }
+  void Set(std::size_t i) { words_[i >> 6] |= std::uint64_t{1} << (i & 63); }
+  void Clear() { std::fill(words_.begin(), words_.end(), 0); }
+  bool Empty() const {
+    return std::all_of(words_.begin(), words_.end(), [](std::uint64_t w) { return w == 0; });
+  }
+  void Swap(Bitmap& other) { words_.swap(other.words_); }
+
+  // Llama a fn(i) para cada bit activo en orden ascendente; para si fn devuelve false.
+  template <typename Fn>
+  void ForEach(Fn fn) const {
+    for (std::size_t k = 0; k < words_.size(); ++k) {
+      for (std::uint64_t w = words_[k]; w != 0; w &= w - 1) {
+        if (!fn(k * 64 + static_cast<std::size_t>(std::countr_zero(w)))) return;
+      }
+    }
+  }
+
+ private:
+  std::vector<std::uint64_t> words_;
+};
+
+// Aplica SearchLimits: se consulta una vez por expansión. El token y el contador son
+// casi gratis; la memoria solo se estima si hay límite y el reloj se mira cada
+// kClockEvery expansiones.
+class LimitGuard {
+ public:
+  explicit LimitGuard(const SearchLimits& limits)
+      : limits_(limits), start_(std::chrono::steady_clock::now()) {}
+
+  // true si no se debe hacer la siguiente expansión; deja el motivo en *reason.
+  // 'memory_bytes' es un callable que estima la memoria actual de la búsqueda.
+  template <typename MemFn>
+  bool Stop(const MemFn& memory_bytes, StopReason* reason) {
+    if (limits_.cancel != nullptr && limits_.cancel->IsCancelled()) {
+      *reason = StopReason::kCancelled;
+    } else if (limits_.max_expansions > 0 && expansions_ >= limits_.max_expansions) {
+      *reason = StopReason::kExpansionLimit;
+    } else if (limits_.max_memory_bytes > 0 && memory_bytes() > limits_.max_memory_bytes) {
+      *reason = StopReason::kMemoryLimit;
+    } else if (limits_.time_budget.count() > 0 && expansions_ % kClockEvery == 0 &&
+               std::chrono::steady_clock::now() - start_ > limits_.time_budget) {
+      *reason = StopReason::kTimeLimit;
+    } else {
+      ++expansions_;
+      return false;
+    }
+    return true;
+  }
+
+ private:
+  static constexpr std::size_t kClockEvery = 64;
+
+  const SearchLimits& limits_;
+  std::chrono::steady_clock::time_point start_;
+  std::size_t expansions_ = 0;
+};
+
+// Registro volcado a disco por cada vértice descubierto en la búsqueda externa.
+struct ParentRecord {
+  int node;
+  int parent;
+};
+
 }  // namespace
 
 //SearchResult UninformedSearch::Run(const Graph& g, int origin, int dest, Strategy strategy) {
@@ -35,35 +125,72 @@ std::vector<int> ReconstructPath(int origin, int goal, const std::vector<int>& p
 //}
 
 
-SearchResult UninformedSearch::Run(const Graph& g, int origin, int dest, Strategy strategy) {
+Strategy StrategyFromString(const std::string& s) {
+  if (s == "dfs" || s == "DFS") return Strategy::kDfs;
+  if (s == "bfs-multi" || s == "BFS-MULTI" || s == "bfsmulti" || s == "BFSMULTI")
+    return Strategy::kBfsMulti;
+  if (s == "bfs-ext" || s == "BFS-EXT") return Strategy::kBfsExternal;
+  return Strategy::kBfs;
+}
+
+const char* StrategyName(Strategy st) {
+  switch (st) {
+    case Strategy::kBfs:         return "BFS";
+    case Strategy::kDfs:         return "DFS";
+    case Strategy::kBfsMulti:    return "BFS-MULTI";
+    case Strategy::kBfsExternal: return "BFS-EXT";
+  }
+  return "?";
+}
+
+const char* StopReasonName(StopReason reason) {
+  switch (reason) {
+    case StopReason::kCompleted:      return "completada";
+    case StopReason::kTimeLimit:      return "limite de tiempo";
+    case StopReason::kExpansionLimit: return "limite de expansiones";
+    case StopReason::kMemoryLimit:    return "limite de memoria";
+    case StopReason::kCancelled:      return "cancelada";
+    case StopReason::kError:          return "error";
+  }
+  return "?";
+}
+
+SearchResult UninformedSearch::Run(const Graph& g, int origin, int dest, Strategy strategy,
+                                   const SearchLimits& limits) {
   if (origin < 1 || dest < 1 ||
       origin > static_cast<int>(g.NumVertices()) ||
       dest   > static_cast<int>(g.NumVertices())) {
     return {};
   }
   switch (strategy) {
-    case Strategy::kBfs:      return Bfs(g, origin, dest);
-    case Strategy::kDfs:      return Dfs(g, origin, dest);
-    case Strategy::kBfsMulti: return BfsMulti(g, origin, dest, 10); // Ponemos el máximo run 
+    case Strategy::kBfs:      return Bfs(g, origin, dest, limits);
+    case Strategy::kDfs:      return Dfs(g, origin, dest, limits);
+    case Strategy::kBfsMulti: return BfsMulti(g, origin, dest, 10, limits); // Ponemos el máximo run 
+    case Strategy::kBfsExternal: {
+      // Necesita el grafo en disco: ver RunExternal
+      std::cerr << "Error: bfs-ext no se ejecuta sobre un grafo en memoria.\n";
+      SearchResult res;
+      res.stop_reason = StopReason::kError;
+      return res;
+    }
   }
    return {};
 }
 
 
 double UninformedSearch::ComputePathCost(const Graph& g, const std::vector<int>& path) {
-  if (path.size() < 2) return 0.0;
-  double cost = 0.0;
-  for (std::size_t i = 1; i < path.size(); ++i) {
-    double w = g.EdgeCost(path[i - 1], path[i]);
-    if (w < 0.0) return -1.0;
-    cost += w;
-  }
-  return cost;
+  return PathCost(g, path);
+}
+
+double UninformedSearch::ComputePathCost(const DiskGraph& g, const std::vector<int>& path) {
+  return PathCost(g, path);
 }
 
 // ======================= BFS =======================
-SearchResult UninformedSearch::Bfs(const Graph& g, int origin, int dest) {
+SearchResult UninformedSearch::Bfs(const Graph& g, int origin, int dest,
+                                   const SearchLimits& limits) {
   SearchResult res;
+  LimitGuard guard(limits);
 
   const int n = static_cast<int>(g.NumVertices());
   std::vector<int> parent(n + 1, -1);
@@ -86,12 +213,17 @@ SearchResult UninformedSearch::Bfs(const Graph& g, int origin, int dest) {
     q.pop_front();
 
     if (inspected[u]) continue;       // nunca inspeccionamos dos veces el mismo nodo
+
+    // Límites: se devuelve lo recorrido hasta aquí con el motivo de parada
+    auto memory = [&] {
+      return (q.size() + gen_acc.size() + insp_acc.size()) * sizeof(int) +
+             res.trace.MemoryBytes();
+    };
+    if (guard.Stop(memory, &res.stop_reason)) return res;
     inspected[u] = true;
 
     // Snapshot AL INICIO de la iteración
-    res.expanded_nodes.push_back(u);
-    res.generated_acc.push_back(gen_acc);
-    res.inspected_acc.push_back(insp_acc);
+    res.trace.BeginStep(u, gen_acc, insp_acc);
 
     // Inspeccionamos u
     insp_acc.push_back(u);
@@ -103,12 +235,9 @@ SearchResult UninformedSearch::Bfs(const Graph& g, int origin, int dest) {
       return res;
     }
 
-    // Generar sucesores en orden ascendente
-    auto neigh = g.Neighbors(u);
-    std::sort(neigh.begin(), neigh.end());
-
+    // Generar sucesores en orden ascendente (Neighbors ya está ordenado)
     std::vector<int> succ_this, enq_this;
-    for (int v : neigh) {
+    for (int v : g.Neighbors(u)) {
       succ_this.push_back(v);
       if (v != parent[u]) gen_acc.push_back(v);  // “generados” con duplicados (excluye padre)
 
@@ -120,8 +249,7 @@ SearchResult UninformedSearch::Bfs(const Graph& g, int origin, int dest) {
       }
     }
 
-    res.successors_step.push_back(succ_this);
-    res.enqueued_step.push_back(enq_this);
+    res.trace.EndStep(succ_this, enq_this);
   }
 
   return res;
@@ -158,8 +286,10 @@ static std::vector<int> ReconstructPathFromStates(
   return rev;
 }
 
-SearchResult UninformedSearch::Dfs(const Graph& g, int origin, int dest) {
+SearchResult UninformedSearch::Dfs(const Graph& g, int origin, int dest,
+                                   const SearchLimits& limits) {
   SearchResult res;
+  LimitGuard guard(limits);
 
   // -------- Estado en la pila: (nodo actual, padre desde el que llego) --------
   struct S { int u; int p; };
@@ -185,10 +315,15 @@ SearchResult UninformedSearch::Dfs(const Graph& g, int origin, int dest) {
     // Si este nodo ya fue inspeccionado, lo ignoramos (no cuenta como iteración)
     if (inspected[cur.u]) continue;
 
+    // Límites: la pila admite duplicados y puede crecer mucho en grafos densos
+    auto memory = [&] {
+      return st.size() * sizeof(S) + (gen_acc.size() + insp_acc.size()) * sizeof(int) +
+             res.trace.MemoryBytes();
+    };
+    if (guard.Stop(memory, &res.stop_reason)) return res;
+
     // ----------  AL INICIO de la iteración (antes de generar sucesores) ----------
-    res.expanded_nodes.push_back(cur.u);
-    res.generated_acc.push_back(gen_acc);
-    res.inspected_acc.push_back(insp_acc);
+    res.trace.BeginStep(cur.u, gen_acc, insp_acc);
 
     // Inspeccionamos por PRIMERA vez este nodo
     inspected[cur.u] = true;
@@ -223,8 +358,10 @@ SearchResult UninformedSearch::Dfs(const Graph& g, int origin, int dest) {
 }
 
 
-SearchResult UninformedSearch::BfsMulti(const Graph& g, int origin, int dest, int max_runs) {
+SearchResult UninformedSearch::BfsMulti(const Graph& g, int origin, int dest, int max_runs,
+                                        const SearchLimits& limits) {
   SearchResult best;  // devolveremos el primer éxito; si no, queda vacío
+  LimitGuard guard(limits);  // compartido por todos los runs
 
   if (origin == dest) {
     best.path = {origin};
@@ -253,13 +390,18 @@ SearchResult UninformedSearch::BfsMulti(const Graph& g, int origin, int dest, in
     // Acumulados para el informe (se resetean en cada ejecución)
     std::vector<int> gen_acc;
     std::vector<int> insp_acc;
+    best.trace.ResetLists();
+
+    auto memory = [&] {
+      return (q.size() + gen_acc.size() + insp_acc.size()) * sizeof(int) +
+             best.trace.MemoryBytes();
+    };
+    if (guard.Stop(memory, &best.stop_reason)) return best;
 
     // -------- Iteración de "inspección del origen" (no se expanden sus sucesores) --------
     // Iteración 1 del run: snapshot del origen
-    best.expanded_nodes.push_back(origin);
     gen_acc.push_back(origin);
-    best.generated_acc.push_back(gen_acc);
-    best.inspected_acc.push_back(insp_acc);
+    best.trace.BeginStep(origin, gen_acc, insp_acc);
     // Marcar inspeccionado el origen en este run
     inspected[origin] = true;
     parent[origin] = -1;
@@ -274,11 +416,10 @@ SearchResult UninformedSearch::BfsMulti(const Graph& g, int origin, int dest, in
     while (!q.empty()) {
       int u = q.front(); q.pop_front();
       if (inspected[u]) continue;
+      if (guard.Stop(memory, &best.stop_reason)) return best;
       inspected[u] = true;
       // Snapshot AL INICIO de la iteración (antes de generar sucesores)
-      best.expanded_nodes.push_back(u);
-      best.generated_acc.push_back(gen_acc);
-      best.inspected_acc.push_back(insp_acc);
+      best.trace.BeginStep(u, gen_acc, insp_acc);
       // Inspeccionamos u
       insp_acc.push_back(u);
       if (u == dest) {
@@ -303,8 +444,7 @@ SearchResult UninformedSearch::BfsMulti(const Graph& g, int origin, int dest, in
         }
       }
 
-      best.successors_step.push_back(succ_this);
-      best.enqueued_step.push_back(enq_this);
+      best.trace.EndStep(succ_this, enq_this);
     }
     // Si no se encontró en este run, se repite el bucle escogiendo otro hijo al azar.
     // (Las trazas de los runs se concatenan en 'best' tal y como están; esto no afecta al camino/coste).
@@ -314,3 +454,123 @@ SearchResult UninformedSearch::BfsMulti(const Graph& g, int origin, int dest, in
 }
 
 
+
+
+// ======================= BFS EXTERNO =======================
+SearchResult UninformedSearch::RunExternal(const DiskGraph& g, int origin, int dest,
+                                           const SearchLimits& limits) {
+  SearchResult res;
+  LimitGuard guard(limits);
+
+  const int n = static_cast<int>(g.NumVertices());
+  if (origin < 1 || dest < 1 || origin > n || dest > n) return res;
+  if (origin == dest) {
+    res.path = {origin};
+    res.total_cost = 0.0;
+    res.found = true;
+    return res;
+  }
+
+  // Nombre único: varias búsquedas sobre el mismo grafo (otros procesos) no se pisan
+  const std::string spill_path = CreateUniqueFile(TempDir() + "/ia-parents-");
+  std::fstream spill;
+  if (!spill_path.empty()) {
+    spill.open(spill_path, std::ios::in | std::ios::out | std::ios::trunc | std::ios::binary);
+  }
+  if (!spill) {
+    std::cerr << "Error: no se pudo crear el fichero de padres en: " << TempDir() << "\n";
+    if (!spill_path.empty()) std::remove(spill_path.c_str());
+    res.stop_reason = StopReason::kError;
+    return res;
+  }
+
+  const std::size_t size = static_cast<std::size_t>(n) + 1;
+  Bitmap visited(size), frontier(size), next(size);
+  std::vector<std::streamoff> level_start;  // inicio en 'spill' de cada nivel (O(profundidad))
+
+  visited.Set(static_cast<std::size_t>(origin));
+  frontier.Set(static_cast<std::size_t>(origin));
+
+  // Niveles completos; la frontera se recorre en orden de id, así las filas se leen
+  // de la proyección en orden creciente (acceso secuencial al fichero).
+  auto memory = [&] { return 3 * (size + 7) / 8 + level_start.size() * sizeof(std::streamoff); };
+  bool found = false;
+  bool stopped = false;
+  bool corrupt = false;  // id de vecino fuera de 1..n (Open no recorre los vecinos)
+  while (!found && !stopped && !corrupt && !frontier.Empty()) {
+    level_start.push_back(spill.tellp());
+    frontier.ForEach([&](std::size_t u) {
+      if (guard.Stop(memory, &res.stop_reason)) {
+        stopped = true;
+        return false;
+      }
+      for (int v : g.Neighbors(static_cast<int>(u))) {
+        if (v < 1 || v > n) {
+          corrupt = true;
+          return false;
+        }
+        const std::size_t k = static_cast<std::size_t>(v);
+        if (visited.Test(k)) continue;
+        visited.Set(k);
+        next.Set(k);
+        const ParentRecord rec{v, static_cast<int>(u)};
+        spill.write(reinterpret_cast<const char*>(&rec), sizeof(rec));
+        if (v == dest) {
+          found = true;
+          return false;
+        }
+      }
+      return true;
+    });
+    frontier.Swap(next);
+    next.Clear();
+  }
+  level_start.push_back(spill.tellp());
+
+  // Un fallo al volcar padres (p. ej. disco lleno) no debe pasar por "no hay camino"
+  if (corrupt) {
+    std::cerr << "Error: vecino fuera de rango en el grafo en disco: " << g.path() << "\n";
+    res.stop_reason = StopReason::kError;
+  } else if (!spill) {
+    std::cerr << "Error: fallo de escritura en el fichero de padres: " << spill_path << "\n";
+    res.stop_reason = StopReason::kError;
+  } else if (found) {
+    // El destino está en el último nivel; su padre, en el anterior, y así hasta el origen.
+    // Cada nivel se lee una vez y de forma secuencial.
+    std::vector<int> rev{dest};
+    int cur = dest;
+    std::vector<ParentRecord> buf(4096);
+    for (std::size_t level = level_start.size() - 1; level-- > 0 && cur != origin;) {
+      spill.seekg(level_start[level]);
+      auto left = static_cast<std::size_t>(level_start[level + 1] - level_start[level]) /
+                  sizeof(ParentRecord);
+      bool hit = false;
+      while (left > 0 && !hit) {
+        const std::size_t chunk = std::min(left, buf.size());
+        spill.read(reinterpret_cast<char*>(buf.data()),
+                   static_cast<std::streamsize>(chunk * sizeof(ParentRecord)));
+        if (!spill) break;
+        for (std::size_t i = 0; i < chunk && !hit; ++i) {
+          if (buf[i].node == cur) {
+            cur = buf[i].parent;
+            rev.push_back(cur);
+            hit = true;
+          }
+        }
+        left -= chunk;
+      }
+    }
+    if (cur == origin) {
+      res.path.assign(rev.rbegin(), rev.rend());
+      res.total_cost = ComputePathCost(g, res.path);
+      res.found = true;
+    } else {
+      std::cerr << "Error: no se pudo leer el fichero de padres: " << spill_path << "\n";
+      res.stop_reason = StopReason::kError;
+    }
+  }
+
+  spill.close();
+  std::remove(spill_path.c_str());
+  return res;
+}
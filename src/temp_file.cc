@@ -0,0 +1,22 @@
+#include "temp_file.h"
+
+#include <unistd.h>
+
+#include <cstdlib>
+#include <vector>
+
+std::string TempDir() {
+  const char* dir = std::getenv("TMPDIR");
+  return dir != nullptr && *dir != '\0' ? dir : "/tmp";
+}
+
+std::string CreateUniqueFile(const std::string& prefix) {
+  // mkstemp sustituye las X en el propio búfer
+  const std::string pattern = prefix + "XXXXXX";
+  std::vector<char> name(pattern.begin(), pattern.end());
+  name.push_back('\0');
+  const int fd = ::mkstemp(name.data());
+  if (fd < 0) return {};
+  ::close(fd);
+  return name.data();
+}
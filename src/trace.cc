@@ -0,0 +1,141 @@
+#include "trace.h"
+
+#include <utility>
+
+namespace {
+
+std::uint64_t ZigZag(std::int64_t v) {
+  return (static_cast<std::uint64_t>(v) << 1) ^ static_cast<std::uint64_t>(v >> 63);
+}
+
+std::int64_t UnZigZag(std::uint64_t v) {
+  return static_cast<std::int64_t>(v >> 1) ^ -static_cast<std::int64_t>(v & 1);
+}
+
+// Escribe 'cur' como (prefijo conservado de la iteración anterior, sufijo nuevo).
+void PutAccumulated(std::vector<std::uint8_t>* buf, std::size_t keep,
+                    const std::vector<int>& cur) {
+  PutVarint(buf, keep);
+  PutIdList(buf, cur.data() + keep, cur.size() - keep);
+}
+
+// Inverso de PutAccumulated: 'acc' contiene la lista anterior y pasa a ser la actual.
+bool GetAccumulated(const std::vector<std::uint8_t>& buf, std::size_t* pos,
+                    std::vector<int>* acc) {
+  std::uint64_t keep = 0;
+  if (!GetVarint(buf, pos, &keep) || keep > acc->size()) return false;
+  std::vector<int> tail;
+  if (!GetIdList(buf, pos, &tail)) return false;
+  acc->resize(static_cast<std::size_t>(keep));
+  acc->insert(acc->end(), tail.begin(), tail.end());
+  return true;
+}
+
+}  // namespace
+
+void PutVarint(std::vector<std::uint8_t>* buf, std::uint64_t v) {
+  while (v >= 0x80) {
+    buf->push_back(static_cast<std::uint8_t>(v | 0x80));
+    v >>= 7;
+  }
+  buf->push_back(static_cast<std::uint8_t>(v));
+}
+
+bool GetVarint(const std::vector<std::uint8_t>& buf, std::size_t* pos, std::uint64_t* v) {
+  std::uint64_t out = 0;
+  for (unsigned shift = 0; shift < 64; shift += 7) {
+    if (*pos >= buf.size()) return false;
+    const std::uint8_t b = buf[(*pos)++];
+    out |= static_cast<std::uint64_t>(b & 0x7f) << shift;
+    if ((b & 0x80) == 0) {
+      *v = out;
+      return true;
+    }
+  }
+  return false;
+}
+
+void PutIdList(std::vector<std::uint8_t>* buf, const int* ids, std::size_t count) {
+  PutVarint(buf, count);
+  std::int64_t prev = 0;
+  for (std::size_t i = 0; i < count; ++i) {
+    PutVarint(buf, ZigZag(ids[i] - prev));
+    prev = ids[i];
+  }
+}
+
+bool GetIdList(const std::vector<std::uint8_t>& buf, std::size_t* pos, std::vector<int>* ids) {
+  std::uint64_t count = 0;
+  if (!GetVarint(buf, pos, &count) || count > buf.size() - *pos) return false;
+  ids->clear();
+  ids->reserve(static_cast<std::size_t>(count));
+  std::int64_t prev = 0;
+  for (std::uint64_t i = 0; i < count; ++i) {
+    std::uint64_t z = 0;
+    if (!GetVarint(buf, pos, &z)) return false;
+    prev += UnZigZag(z);
+    ids->push_back(static_cast<int>(prev));
+  }
+  return true;
+}
+
+void Trace::CloseOpenStep() {
+  if (!open_) return;
+  PutVarint(&buf_, 0);  // sin sucesores
+  PutVarint(&buf_, 0);  // sin encolados
+  open_ = false;
+}
+
+void Trace::BeginStep(int expanded, const std::vector<int>& generated,
+                      const std::vector<int>& inspected) {
+  CloseOpenStep();
+  PutVarint(&buf_, ZigZag(expanded));
+  // Las listas solo crecen por el final (ver BeginStep en trace.h): se conserva la lista
+  // anterior entera. La comparación del elemento frontera es solo una salvaguarda.
+  for (auto [prev, cur] : {std::pair{&prev_generated_, &generated},
+                           std::pair{&prev_inspected_, &inspected}}) {
+    const bool kept = prev->size <= cur->size() &&
+                      (prev->size == 0 || (*cur)[prev->size - 1] == prev->last);
+    PutAccumulated(&buf_, kept ? prev->size : 0, *cur);
+    *prev = {cur->size(), cur->empty() ? 0 : cur->back()};
+  }
+  open_ = true;
+  ++steps_;
+}
+
+void Trace::EndStep(const std::vector<int>& successors, const std::vector<int>& enqueued) {
+  if (!open_) return;
+  PutIdList(&buf_, successors.data(), successors.size());
+  PutIdList(&buf_, enqueued.data(), enqueued.size());
+  open_ = false;
+}
+
+Trace Trace::FromBytes(std::vector<std::uint8_t> bytes, std::size_t num_steps) {
+  Trace t;
+  t.buf_ = std::move(bytes);
+  t.steps_ = num_steps;
+  return t;
+}
+
+Trace::Reader::Status Trace::Reader::Next(Step* step) {
+  const auto& buf = trace_.buf_;
+  if (step_ >= trace_.steps_) return pos_ == buf.size() ? Status::kEnd : Status::kError;
+  std::uint64_t z = 0;
+  if (!GetVarint(buf, &pos_, &z)) return Status::kError;
+  step->expanded = static_cast<int>(UnZigZag(z));
+  if (!GetAccumulated(buf, &pos_, &generated_) || !GetAccumulated(buf, &pos_, &inspected_)) {
+    return Status::kError;
+  }
+  step->generated = generated_;
+  step->inspected = inspected_;
+  // La última iteración puede quedar abierta (p. ej. al alcanzar el destino)
+  step->successors.clear();
+  step->enqueued.clear();
+  const bool open_last = step_ + 1 == trace_.steps_ && pos_ == buf.size();
+  if (!open_last &&
+      (!GetIdList(buf, &pos_, &step->successors) || !GetIdList(buf, &pos_, &step->enqueued))) {
+    return Status::kError;
+  }
+  ++step_;
+  return Status::kStep;
+}
@@ -0,0 +1,33 @@
+// Genera el informe legible a partir de una traza binaria (busquedas --trace).
+//
+// Uso: trace_report <traza> [salida]   (sin salida, escribe por la salida estándar)
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+
+#include "report.h"
+
+int main(int argc, char* argv[]) {
+  if (argc < 2 || argc > 3) {
+    std::cerr << "Uso: " << argv[0] << " <traza> [salida]\n";
+    return EXIT_FAILURE;
+  }
+
+  ReportHeader header;
+  SearchResult r;
+  if (!ReadTraceFile(argv[1], &header, &r)) return EXIT_FAILURE;
+
+  if (argc == 2) return WriteReport(std::cout, header, r) ? EXIT_SUCCESS : EXIT_FAILURE;
+  std::ofstream out(argv[2]);
+  if (!out) {
+    std::cerr << "Error: no se pudo abrir el fichero de salida: " << argv[2] << "\n";
+    return EXIT_FAILURE;
+  }
+  if (!WriteReport(out, header, r)) {
+    std::cerr << "Error: informe incompleto en: " << argv[2] << "\n";
+    return EXIT_FAILURE;
+  }
+  std::cout << "Informe generado en: " << argv[2] << "\n";
+  return EXIT_SUCCESS;
+}